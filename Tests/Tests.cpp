@@ -9,14 +9,366 @@
 #include "getrs.h"
 
 #include "matrix.h"
+#include "allocator.h"
+#include "sharedmatrix.h"
+#include "polynomialroots.h"
+#include "schurcohn.h"
+#include "rationalexpansion.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <limits>
 
 using namespace NUMCPP;
 using namespace CD_STATS;
 
 CONSTANTS<double> cnt;
 
+namespace {
+
+	int failures = 0;
+
+	void check(const char* name, bool ok) {
+		std::cout << (ok ? "ok      " : "FAILED  ") << name << std::endl;
+		if (!ok)
+			++failures;
+	}
+
+	void* g_released = nullptr;
+
+	// Block of a pool released by a thread_local destructor that runs after the
+	// destruction of the thread cache of the pool
+	struct LateRelease {
+		PoolAllocator* pool = nullptr;
+		void* block = nullptr;
+
+		~LateRelease() {
+			if (block != nullptr) {
+				pool->deallocate(block, 64);
+				g_released = block;
+			}
+		}
+	};
+
+	thread_local LateRelease t_late;
+
+	void testPoolThreadExit() {
+		PoolAllocator pool;
+		std::thread worker([&pool]() {
+			// t_late is constructed before the thread cache, so that it is destroyed after it
+			t_late.pool = &pool;
+			t_late.block = pool.allocate(64);
+			});
+		worker.join();
+		AllocatorStatistics s = pool.statistics();
+		check("pool: release from a thread_local destructor", s.allocations == 1 && s.deallocations == 1 && s.bytesInUse == 0);
+		// the block went back on the top of the shared list (not in the destroyed cache)
+		void* p = pool.allocate(64);
+		check("pool: block reused after the thread exit", p != nullptr && p == g_released);
+		pool.deallocate(p, 64);
+	}
+
+	// y(i) = x(i) in the increasing order of i, on copies of the data
+	bool sameAsOrderedCopy(double* a, int n, int dst, int incy, int src, int incx, int m) {
+		std::vector<double> ref(a, a + n), cur(a, a + n);
+		for (int i = 0; i < m; ++i)
+			ref[dst + i * incy] = ref[src + i * incx];
+		Sequence<double>(cur.data() + dst, m, incy).copy(Sequence<double>(cur.data() + src, m, incx));
+		return ref == cur;
+	}
+
+	void testOverlappingCopy() {
+		double a[64];
+		for (int i = 0; i < 64; ++i)
+			a[i] = i;
+		// contiguous: as through a temporary
+		std::vector<double> v(a, a + 64);
+		Sequence<double>(v.data() + 1, 40).copy(Sequence<double>(v.data(), 40));
+		bool ok = v[0] == 0;
+		for (int i = 1; i <= 40; ++i)
+			ok = ok && v[i] == i - 1;
+		v.assign(a, a + 64);
+		Sequence<double>(v.data(), 40).copy(Sequence<double>(v.data() + 3, 40));
+		for (int i = 0; i < 40; ++i)
+			ok = ok && v[i] == i + 3;
+		check("copy: overlapping contiguous sequences", ok);
+		check("copy: overlapping strided sequences",
+			sameAsOrderedCopy(a, 64, 2, 2, 0, 2, 20)
+			&& sameAsOrderedCopy(a, 64, 0, 3, 1, 2, 20)
+			&& sameAsOrderedCopy(a, 64, 0, 1, 1, 3, 20)
+			&& sameAsOrderedCopy(a, 64, 5, 3, 0, 1, 19)
+			&& sameAsOrderedCopy(a, 64, 63, -3, 0, 2, 21));
+	}
+
+	void testSharedMatrixLength() {
+		bool thrown = false;
+		try {
+			SharedMatrix<double> M(1 << 16, 1 << 16);
+		}
+		catch (const std::length_error&) {
+			thrown = true;
+		}
+		check("shared matrix: more than INT_MAX items rejected", thrown);
+	}
+
+	void testFrequencyGrid() {
+		double c[41];
+		for (int i = 0; i <= 40; ++i)
+			c[i] = 1.0 / (i + 1) - (i % 3) * .1;
+		Polynomial P(40, c);
+		// Fourier grid of size 1024 (FFT path), then a grid that is not a Fourier one (Horner)
+		const double pi = 3.14159265358979323846;
+		double dws[2] = { 2 * pi / 1024, .0123 };
+		bool ok = true;
+		for (double dw : dws) {
+			std::vector<std::complex<double>> f(513);
+			P.evaluateAtFrequencies(0, dw, 513, f.data());
+			for (int k = 0; k < 513; ++k)
+				ok = ok && std::abs(f[k] - P.evaluateAtFrequency(k * dw)) < 1e-12;
+		}
+		check("polynomial: frequency grids", ok);
+	}
+
+	// Deterministic coefficients in [-1, 1[
+	void fill(double* c, int n, unsigned seed) {
+		for (int i = 0; i < n; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			c[i] = (seed >> 8) * (2.0 / (1 << 24)) - 1;
+		}
+	}
+
+	// |p(z)| relative to sum |c[i]| |z|^i
+	double residual(const Polynomial& p, const std::complex<double>& z) {
+		double s = 0, az = std::abs(z), zi = 1;
+		for (int i = 0; i <= p.getDegree(); ++i, zi *= az)
+			s += std::abs(p[i]) * zi;
+		return std::abs(p.evaluateAt(z)) / s;
+	}
+
+	void testRoots() {
+		bool ok = true;
+		PolynomialRoots::Method methods[2] = { PolynomialRoots::Aberth, PolynomialRoots::Companion };
+		for (int d : { 3, 8, 20, 40 }) {
+			std::vector<double> c(d + 1);
+			fill(c.data(), d + 1, d);
+			Polynomial p(d, c.data());
+			for (PolynomialRoots::Method m : methods) {
+				std::vector<std::complex<double>> r(d);
+				ok = ok && PolynomialRoots::roots(p, r.data(), m) == d;
+				for (int j = 0; j < d; ++j)
+					ok = ok && residual(p, r[j]) < 1e-12;
+			}
+		}
+		check("roots: residuals", ok);
+		double c[4] = { 1, std::numeric_limits<double>::quiet_NaN(), .5, 1 };
+		check("roots: failed solve in minModulus", std::isnan(PolynomialRoots::minModulus(Polynomial(3, c))));
+	}
+
+	void testSchurCohn() {
+		const int d = 6, count = 400;
+		std::vector<double> c(count * (d + 1));
+		for (int k = 0; k < count; ++k) {
+			double* ck = c.data() + k * (d + 1);
+			fill(ck, d + 1, 1000 + k);
+			// from strongly stable to mostly unstable polynomials
+			double scale = .1 + 1.5 * k / count;
+			ck[0] = 1;
+			for (int i = 1; i <= d; ++i)
+				ck[i] *= scale;
+		}
+		bool stable[count], pstable[count];
+		SchurCohn::isStable(execution::seq, c.data(), d, count, stable);
+		SchurCohn::isStable(execution::par, c.data(), d, count, pstable);
+		bool ok = std::equal(stable, stable + count, pstable);
+		int nstable = 0;
+		for (int k = 0; k < count; ++k) {
+			Polynomial p(d, c.data() + k * (d + 1));
+			double rmin = PolynomialRoots::minModulus(p);
+			ok = ok && SchurCohn::isStable(p) == stable[k];
+			// the roots on the unit circle (up to rounding) are undecided
+			if (std::abs(rmin - 1) > 1e-8)
+				ok = ok && stable[k] == (rmin > 1);
+			if (stable[k])
+				++nstable;
+		}
+		check("schur-cohn: same result as the roots", ok && nstable > 0 && nstable < count);
+	}
+
+	// max |(w * denom)[k] - num[k]|, k in [0, n[
+	double expansionError(const Polynomial& num, const Polynomial& denom, const double* w, int n) {
+		double e = 0;
+		for (int k = 0; k < n; ++k) {
+			double s = k <= num.getDegree() ? num[k] : 0;
+			for (int l = 0; l <= std::min(k, denom.getDegree()); ++l)
+				s -= denom[l] * w[k - l];
+			e = std::max(e, std::abs(s));
+		}
+		return e;
+	}
+
+	void testRationalExpansion() {
+		// numerator shorter than the denominator
+		double b[3] = { 1, -.2, .1 }, a[6] = { 1, -.5, .2, 0, .1, -.05 };
+		Polynomial num(2, b), denom(5, a);
+		double w[30];
+		num.rationalFunctionExpansion(denom, 30, w);
+		bool ok = expansionError(num, denom, w, 30) < 1e-14;
+		// the same one, computed in pieces
+		RationalExpansion e(num, denom);
+		double piece[7];
+		for (int k = 0; k < 28; k += 7) {
+			e.next(7, piece);
+			ok = ok && std::equal(piece, piece + 7, w + k);
+		}
+		check("rational expansion: recurrence", ok);
+		// high-degree denominator: Newton's iterations, checked against the recurrence
+		const int p = 1000, n = 4096;
+		std::vector<double> c(p + 1);
+		fill(c.data(), p + 1, 7);
+		c[0] = 1;
+		for (int i = 1; i <= p; ++i)
+			c[i] *= .5 / p;
+		Polynomial ar(p, c.data());
+		std::vector<double> wr(n);
+		num.rationalFunctionExpansion(ar, n, wr.data());
+		RationalExpansion big(num, ar);
+		const double* wn = big.expand(n);
+		double err = 0, scale = 0;
+		for (int k = 0; k < n; ++k) {
+			err = std::max(err, std::abs(wn[k] - wr[k]));
+			scale = std::max(scale, std::abs(wr[k]));
+		}
+		check("rational expansion: Newton's iterations", big.size() == n && err < 1e-10 * scale);
+	}
+
+	bool near(const Polynomial& p, const Polynomial& q, double eps) {
+		if (p.getDegree() != q.getDegree())
+			return false;
+		for (int i = 0; i <= p.getDegree(); ++i) {
+			if (std::abs(p[i] - q[i]) > eps)
+				return false;
+		}
+		return true;
+	}
+
+	void testCommonFactors() {
+		double ca[6] = { 1, 1, 2, 0, 0, 1 }, cb[3] = { 1, -.5, 1 };
+		Polynomial a(5, ca), b(2, cb), q, r;
+		Polynomial::divide(a, b, q, r);
+		bool ok = r.getDegree() < 2 && near(q * b + r, a, 1e-12);
+		Polynomial q2, r2 = a;
+		Polynomial::divide(r2, b, q2, r2);
+		ok = ok && near(q2, q, 0) && near(r2, r, 0);
+		// (1 + 2x + 3x^2 + 4x^3 + 5x^4) / (1 + x + x^2): q = 5x^2 - x - 1, r = 4x + 2
+		double cn[5] = { 1, 2, 3, 4, 5 }, cd[3] = { 1, 1, 1 }, cq[3] = { -1, -1, 5 }, cr[2] = { 2, 4 };
+		Polynomial qr;
+		Polynomial::divide(Polynomial(4, cn), Polynomial(2, cd), qr, qr);
+		ok = ok && near(qr, Polynomial(1, cr), 1e-12);
+		Polynomial::divide(Polynomial(4, cn), Polynomial(2, cd), q, r);
+		ok = ok && near(q, Polynomial(2, cq), 1e-12) && near(r, Polynomial(1, cr), 1e-12);
+		check("polynomial: division", ok);
+
+		// common factor with complex roots 1.2 +- 1.6i
+		double cf[3] = { 1, -.6, .25 }, c1[2] = { 1, -.3 }, c2[2] = { 1, .4 }, c3[2] = { 1, -.2 };
+		Polynomial f(2, cf), p1(1, c1), p2(1, c2), p3(1, c3);
+		Polynomial g = Polynomial::approximateGcd(f * p1, f * p2 * p3);
+		check("polynomial: gcd with conjugate roots", near(g, f, 1e-10));
+
+		Arima arima(f * p1, Polynomial::ONE, f * p2, 1);
+		int n = arima.simplify();
+		check("arima: simplify", n == 2 && near(arima.getStationaryAr(), p1, 1e-10)
+			&& near(arima.getAr(), p1, 1e-10) && near(arima.getMa(), p2, 1e-10));
+
+		// constant terms other than 1 are kept
+		Arima scaled(f * p1 * 2.0, Polynomial::ONE, f * p2 * .5, 1);
+		n = scaled.simplify();
+		check("arima: simplify keeps the constant terms", n == 2 && near(scaled.getStationaryAr(), p1 * 2.0, 1e-10)
+			&& near(scaled.getMa(), p2 * .5, 1e-10));
+
+		// roots 100 and 100.005 match within 1e-4 * 100, but the remainders are too large
+		double c100[2] = { 1, -.01 }, c100b[2] = { 1, -1 / 100.005 };
+		Polynomial far(1, c100), farb(1, c100b);
+		Arima nearly(far * p1, Polynomial::ONE, farb * p2, 1);
+		bool matched = Polynomial::approximateGcd(nearly.getStationaryAr(), nearly.getMa(), 1e-4).getDegree() == 1;
+		n = nearly.simplify(1e-4);
+		check("arima: simplify checks the remainders", matched && n == 0 && near(nearly.getStationaryAr(), far * p1, 0));
+
+		// common roots 0 and 2: only the second one is cancelled
+		double cx[2] = { 0, 1 }, cz[2] = { 1, -.5 };
+		Polynomial x(1, cx), z(1, cz);
+		Arima zero(x * z, Polynomial::ONE, x * z * p2, 1);
+		n = zero.simplify();
+		check("arima: simplify with a root at 0", n == 1 && near(zero.getStationaryAr(), x, 1e-12)
+			&& near(zero.getMa(), x * p2, 1e-12));
+	}
+
+	void testExpressionResize() {
+		DataBlock<double> b(1000);
+		for (int i = 0; i < 1000; ++i)
+			b(i) = i;
+		b = b.all().extract(0, 500) * 2.0;
+		bool ok = b.length() == 500;
+		for (int i = 0; ok && i < 500; ++i)
+			ok = b(i) == 2.0 * i;
+		check("expressions: block resized from its own items", ok);
+	}
+
+	void testSharedPolynomial() {
+		std::vector<double> c(61);
+		fill(c.data(), 61, 3);
+		Polynomial p(60, c.data());
+		Polynomial q(p), r;
+		r = q;
+		bool ok = !p.isInline() && p.isShared() && q.isShared() && r.isShared();
+		// the copy modified gets its own coefficients
+		q *= 2.0;
+		ok = ok && !q.isShared() && p.isShared() && q[5] == 2 * c[5] && p[5] == c[5] && r[5] == c[5];
+		r += p;
+		ok = ok && !p.isShared() && r[7] == 2 * c[7] && p[7] == c[7];
+		// copies and reads from several threads
+		Polynomial s(p);
+		std::vector<std::thread> threads;
+		std::vector<double> values(4);
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&s, &values, t]() {
+				double v = 0;
+				for (int k = 0; k < 1000; ++k) {
+					Polynomial copy(s);
+					v += copy.evaluateAt(.5);
+				}
+				values[t] = v;
+				});
+		}
+		for (std::thread& t : threads)
+			t.join();
+		double v0 = p.evaluateAt(.5);
+		for (int t = 0; t < 4; ++t)
+			ok = ok && std::abs(values[t] - 1000 * v0) <= 1e-9 * std::abs(1000 * v0);
+		check("polynomial: shared heap coefficients", ok && s.isShared());
+	}
+
+	void testSummation() {
+		double x[3] = { 1e16, 1, -1e16 };
+		Sequence<double> s(x, 3);
+		check("summation: compensated sum", s.sum(Summation::Compensated) == 1);
+	}
+}
+
 int main() {
 
+	testPoolThreadExit();
+	testOverlappingCopy();
+	testSharedMatrixLength();
+	testFrequencyGrid();
+	testRoots();
+	testSchurCohn();
+	testRationalExpansion();
+	testCommonFactors();
+	testExpressionResize();
+	testSharedPolynomial();
+	testSummation();
+
 	double ar[4] = { 1, 0, 0,-.3 };
 	double ma[3] = { 1,-.2,.1 };
 
@@ -58,7 +410,7 @@ int main() {
 	A.rand();
 
 	FastMatrix<double> a=A.all();
-	int* piv = new int[m];
+	index_t* piv = new index_t[m];
 	const auto start2 = std::chrono::steady_clock::now();
 	getf2(m, n, &a(0, 0), m, piv);
 	const auto end2 = std::chrono::steady_clock::now();
@@ -73,5 +425,6 @@ int main() {
 //	std::cout << A;
 	LCPP::GETRS<double> getrs;
 	LCPP::TRSM<double> trsm;
-}
 
+	return failures;
+}
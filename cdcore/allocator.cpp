@@ -0,0 +1,434 @@
+#include <cstdlib>
+#include <new>
+#include "allocator.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+using namespace NUMCPP;
+
+namespace {
+
+	// 8 classes of 16 bytes up to 128 bytes, then 4 classes per power of 2 up to MAX_SIZE
+	const int NCLASSES = 8 + 4 * 8;
+
+	void* reserveArena(size_t size, bool huge, bool& gotHuge) {
+		gotHuge = false;
+#if defined(_WIN32)
+		if (huge) {
+			SIZE_T large = GetLargePageMinimum();
+			if (large != 0 && size % large == 0) {
+				void* p = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+				if (p != NULL) {
+					gotHuge = true;
+					return p;
+				}
+			}
+		}
+		return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__unix__) || defined(__APPLE__)
+		void* p;
+#ifdef MAP_HUGETLB
+		if (huge) {
+			p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (p != MAP_FAILED) {
+				gotHuge = true;
+				return p;
+			}
+		}
+#endif
+		p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			return nullptr;
+#ifdef MADV_HUGEPAGE
+		// transparent huge pages
+		if (huge && madvise(p, size, MADV_HUGEPAGE) == 0)
+			gotHuge = true;
+#endif
+		return p;
+#else
+		return std::malloc(size);
+#endif
+	}
+
+	void releaseArena(void* p, size_t size) {
+#if defined(_WIN32)
+		VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__unix__) || defined(__APPLE__)
+		munmap(p, size);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void* MallocAllocator::allocate(size_t size) {
+	void* p = std::malloc(size);
+	if (p != nullptr) {
+		m_allocations.fetch_add(1, std::memory_order_relaxed);
+		m_bytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+	}
+	return p;
+}
+
+void MallocAllocator::deallocate(void* p, size_t size) {
+	if (p == nullptr)
+		return;
+	std::free(p);
+	m_deallocations.fetch_add(1, std::memory_order_relaxed);
+	m_bytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+}
+
+AllocatorStatistics MallocAllocator::statistics()const {
+	AllocatorStatistics s;
+	s.allocations = m_allocations.load(std::memory_order_relaxed);
+	s.deallocations = m_deallocations.load(std::memory_order_relaxed);
+	s.largeAllocations = s.allocations;
+	s.bytesInUse = m_bytes.load(std::memory_order_relaxed);
+	return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+	thread_local bool t_cacheDestroyed = false;
+}
+
+/// <summary>
+/// Free lists of a thread. The counters are only written by their thread,
+/// and read by PoolAllocator::statistics.
+/// </summary>
+struct PoolAllocator::ThreadCache {
+
+	ThreadCache() :owner(nullptr) {
+		clear();
+	}
+
+	~ThreadCache() {
+		if (owner != nullptr) {
+			owner->flush(this);
+			owner->detach(this);
+		}
+		// the destructors that run later on this thread (other thread_local or static objects)
+		// must not attach the cache again: they use the shared lists. The flag is outside
+		// of the cache: a store in a member of a dying object may be discarded by the compiler
+		t_cacheDestroyed = true;
+	}
+
+	void clear() {
+		for (int c = 0; c < NCLASSES; ++c) {
+			lists[c] = nullptr;
+			counts[c] = 0;
+		}
+	}
+
+	void resetCounters() {
+		allocations.store(0, std::memory_order_relaxed);
+		deallocations.store(0, std::memory_order_relaxed);
+		hits.store(0, std::memory_order_relaxed);
+		large.store(0, std::memory_order_relaxed);
+		bytes.store(0, std::memory_order_relaxed);
+	}
+
+	void add(std::atomic<std::uint64_t>& counter) {
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	void add(std::int64_t bytes) {
+		this->bytes.store(this->bytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+	}
+
+	PoolAllocator* owner;
+	FreeBlock* lists[NCLASSES];
+	int counts[NCLASSES];
+	std::atomic<std::uint64_t> allocations{ 0 }, deallocations{ 0 }, hits{ 0 }, large{ 0 };
+	std::atomic<std::int64_t> bytes{ 0 };
+};
+
+namespace {
+	thread_local PoolAllocator::ThreadCache t_cache;
+}
+
+PoolAllocator::PoolAllocator(bool hugePages) :m_huge(hugePages), m_central(NCLASSES), m_cur(nullptr), m_end(nullptr) {
+}
+
+PoolAllocator::~PoolAllocator() {
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		for (ThreadCache* tc : m_caches) {
+			tc->clear();
+			tc->owner = nullptr;
+		}
+		m_caches.clear();
+	}
+	for (const Arena& arena : m_arenas)
+		releaseArena(arena.base, arena.size);
+}
+
+int PoolAllocator::classCount() {
+	return NCLASSES;
+}
+
+int PoolAllocator::classOf(size_t size) {
+	if (size <= 128)
+		return size == 0 ? 0 : static_cast<int>((size + 15) / 16) - 1;
+	// size in ]2^p, 2^(p+1)], split in 4 classes of 2^(p-2) bytes
+	int p = 7;
+	size_t v = (size - 1) >> 8;
+	while (v != 0) {
+		++p;
+		v >>= 1;
+	}
+	int k = static_cast<int>(((size - 1) - (size_t(1) << p)) >> (p - 2));
+	return 8 + 4 * (p - 7) + k;
+}
+
+size_t PoolAllocator::classSize(int c) {
+	if (c < 8)
+		return 16 * size_t(c + 1);
+	int p = 7 + (c - 8) / 4, k = (c - 8) % 4;
+	return (size_t(1) << p) + size_t(k + 1) * (size_t(1) << (p - 2));
+}
+
+int PoolAllocator::batchOf(int c) {
+	int n = static_cast<int>(BATCH_BYTES / classSize(c));
+	return n < 1 ? 1 : (n > MAX_BATCH ? MAX_BATCH : n);
+}
+
+PoolAllocator::ThreadCache* PoolAllocator::cache() {
+	if (t_cacheDestroyed)
+		return nullptr;
+	ThreadCache& tc = t_cache;
+	if (tc.owner == this)
+		return &tc;
+	if (tc.owner == nullptr) {
+		attach(&tc);
+		return &tc;
+	}
+	// the thread is already served by another pool
+	return nullptr;
+}
+
+void PoolAllocator::attach(ThreadCache* tc) {
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	tc->owner = this;
+	tc->resetCounters();
+	m_caches.push_back(tc);
+}
+
+void PoolAllocator::detach(ThreadCache* tc) {
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	m_retired.allocations += tc->allocations.load(std::memory_order_relaxed);
+	m_retired.deallocations += tc->deallocations.load(std::memory_order_relaxed);
+	m_retired.cacheHits += tc->hits.load(std::memory_order_relaxed);
+	m_retired.largeAllocations += tc->large.load(std::memory_order_relaxed);
+	m_retired.bytesInUse += tc->bytes.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < m_caches.size(); ++i) {
+		if (m_caches[i] == tc) {
+			m_caches[i] = m_caches.back();
+			m_caches.pop_back();
+			break;
+		}
+	}
+	tc->owner = nullptr;
+}
+
+char* PoolAllocator::carve(size_t bytes) {
+	std::lock_guard<std::mutex> lock(m_arenaMutex);
+	if (m_cur == nullptr || static_cast<size_t>(m_end - m_cur) < bytes) {
+		bool huge;
+		void* p = reserveArena(ARENA_SIZE, m_huge, huge);
+		if (p == nullptr)
+			return nullptr;
+		m_arenas.push_back(Arena{ p, ARENA_SIZE, huge });
+		m_cur = static_cast<char*>(p);
+		m_end = m_cur + ARENA_SIZE;
+	}
+	char* p = m_cur;
+	m_cur += bytes;
+	return p;
+}
+
+int PoolAllocator::refill(int c, FreeBlock*& head) {
+	int nmax = batchOf(c);
+	int n = 0;
+	head = nullptr;
+	{
+		Central& central = m_central[c];
+		std::lock_guard<std::mutex> lock(central.mutex);
+		FreeBlock* tail = central.head;
+		if (tail != nullptr) {
+			n = 1;
+			while (n < nmax && tail->next != nullptr) {
+				tail = tail->next;
+				++n;
+			}
+			head = central.head;
+			central.head = tail->next;
+			tail->next = nullptr;
+		}
+	}
+	if (n > 0)
+		return n;
+	size_t sz = classSize(c);
+	char* p = carve(nmax * sz);
+	if (p == nullptr)
+		return 0;
+	for (int i = nmax - 1; i >= 0; --i) {
+		FreeBlock* b = reinterpret_cast<FreeBlock*>(p + i * sz);
+		b->next = head;
+		head = b;
+	}
+	return nmax;
+}
+
+void PoolAllocator::release(int c, FreeBlock* head, FreeBlock* tail) {
+	Central& central = m_central[c];
+	std::lock_guard<std::mutex> lock(central.mutex);
+	tail->next = central.head;
+	central.head = head;
+}
+
+void* PoolAllocator::allocate(size_t size) {
+	ThreadCache* tc = cache();
+	if (size > MAX_SIZE) {
+		void* p = std::malloc(size);
+		if (p != nullptr && tc != nullptr) {
+			tc->add(tc->allocations);
+			tc->add(tc->large);
+			tc->add(static_cast<std::int64_t>(size));
+		}
+		else if (p != nullptr)
+			count(static_cast<std::int64_t>(size), true);
+		return p;
+	}
+	int c = classOf(size);
+	FreeBlock* b;
+	if (tc == nullptr) {
+		// the blocks are not cached; the whole batch goes back to the shared list
+		int n = refill(c, b);
+		if (n == 0)
+			return nullptr;
+		if (b->next != nullptr) {
+			FreeBlock* tail = b->next;
+			while (tail->next != nullptr)
+				tail = tail->next;
+			release(c, b->next, tail);
+		}
+		count(static_cast<std::int64_t>(classSize(c)), false);
+		return b;
+	}
+	b = tc->lists[c];
+	if (b != nullptr) {
+		tc->lists[c] = b->next;
+		--tc->counts[c];
+		tc->add(tc->hits);
+	}
+	else {
+		int n = refill(c, b);
+		if (n == 0)
+			return nullptr;
+		tc->lists[c] = b->next;
+		tc->counts[c] = n - 1;
+	}
+	tc->add(tc->allocations);
+	tc->add(static_cast<std::int64_t>(classSize(c)));
+	return b;
+}
+
+void PoolAllocator::deallocate(void* p, size_t size) {
+	if (p == nullptr)
+		return;
+	ThreadCache* tc = cache();
+	if (size > MAX_SIZE) {
+		std::free(p);
+		if (tc != nullptr) {
+			tc->add(tc->deallocations);
+			tc->add(-static_cast<std::int64_t>(size));
+		}
+		else
+			count(-static_cast<std::int64_t>(size), true);
+		return;
+	}
+	int c = classOf(size);
+	FreeBlock* b = static_cast<FreeBlock*>(p);
+	if (tc == nullptr) {
+		release(c, b, b);
+		count(-static_cast<std::int64_t>(classSize(c)), false);
+		return;
+	}
+	tc->add(tc->deallocations);
+	tc->add(-static_cast<std::int64_t>(classSize(c)));
+	b->next = tc->lists[c];
+	tc->lists[c] = b;
+	int batch = batchOf(c);
+	if (++tc->counts[c] > 2 * batch) {
+		// gives a batch back to the other threads
+		FreeBlock* tail = b;
+		for (int i = 1; i < batch; ++i)
+			tail = tail->next;
+		tc->lists[c] = tail->next;
+		tc->counts[c] -= batch;
+		release(c, b, tail);
+	}
+}
+
+void PoolAllocator::flushThreadCache() {
+	if (t_cache.owner == this)
+		flush(&t_cache);
+}
+
+void PoolAllocator::flush(ThreadCache* tc) {
+	for (int c = 0; c < NCLASSES; ++c) {
+		FreeBlock* head = tc->lists[c];
+		if (head != nullptr) {
+			FreeBlock* tail = head;
+			while (tail->next != nullptr)
+				tail = tail->next;
+			release(c, head, tail);
+		}
+	}
+	tc->clear();
+}
+
+void PoolAllocator::count(std::int64_t bytes, bool large) {
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	if (bytes >= 0)
+		++m_retired.allocations;
+	else
+		++m_retired.deallocations;
+	if (large && bytes >= 0)
+		++m_retired.largeAllocations;
+	m_retired.bytesInUse += bytes;
+}
+
+AllocatorStatistics PoolAllocator::statistics()const {
+	AllocatorStatistics s;
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		s = m_retired;
+		for (const ThreadCache* tc : m_caches) {
+			s.allocations += tc->allocations.load(std::memory_order_relaxed);
+			s.deallocations += tc->deallocations.load(std::memory_order_relaxed);
+			s.cacheHits += tc->hits.load(std::memory_order_relaxed);
+			s.largeAllocations += tc->large.load(std::memory_order_relaxed);
+			s.bytesInUse += tc->bytes.load(std::memory_order_relaxed);
+		}
+	}
+	std::lock_guard<std::mutex> lock(m_arenaMutex);
+	for (const Arena& arena : m_arenas) {
+		++s.arenas;
+		s.arenaBytes += arena.size;
+		if (arena.huge)
+			++s.hugePageArenas;
+	}
+	return s;
+}
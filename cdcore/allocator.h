@@ -0,0 +1,160 @@
+#ifndef __numcpp_allocator_h
+#define __numcpp_allocator_h
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "config.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Counters of an allocator. They are gathered without locking the allocation
+    /// paths, so that a snapshot taken while other threads allocate is approximate.
+    /// </summary>
+    struct AllocatorStatistics {
+        // number of calls to allocate/deallocate
+        std::uint64_t allocations = 0, deallocations = 0;
+        // allocations served by the cache of the calling thread
+        std::uint64_t cacheHits = 0;
+        // allocations too large for the size classes (served by malloc)
+        std::uint64_t largeAllocations = 0;
+        // bytes handed out and not yet released (rounded to the size classes)
+        std::int64_t bytesInUse = 0;
+        // memory reserved from the system for the size classes
+        std::uint64_t arenas = 0, arenaBytes = 0, hugePageArenas = 0;
+    };
+
+    /// <summary>
+    /// Memory source of _vectorallocator (and thus of _vector, _cvector, _svector, Polynomial...).
+    /// Blocks must be aligned on 16 bytes; deallocate receives the size given to allocate.
+    /// allocate returns NULL on failure.
+    /// </summary>
+    class Allocator {
+    public:
+
+        virtual ~Allocator() {}
+
+        virtual void* allocate(size_t size) = 0;
+
+        virtual void deallocate(void* p, size_t size) = 0;
+
+        virtual AllocatorStatistics statistics()const = 0;
+    };
+
+    /// <summary>
+    /// Plain malloc/free
+    /// </summary>
+    class MallocAllocator : public Allocator {
+    public:
+
+        void* allocate(size_t size)override;
+
+        void deallocate(void* p, size_t size)override;
+
+        AllocatorStatistics statistics()const override;
+
+    private:
+
+        std::atomic<std::uint64_t> m_allocations{ 0 }, m_deallocations{ 0 };
+        std::atomic<std::int64_t> m_bytes{ 0 };
+    };
+
+    /// <summary>
+    /// Size-class allocator for the many small, short-lived blocks of the library.
+    /// Requests up to MAX_SIZE bytes are rounded to a size class (16-byte steps up to 128 bytes,
+    /// then 4 classes per power of 2). Each thread keeps a free list per class, so that most
+    /// allocations and deallocations take no lock; the lists exchange batches of blocks with
+    /// shared free lists (one lock per class), which are fed by arenas of ARENA_SIZE bytes,
+    /// optionally backed by huge pages. Arenas are only released with the allocator.
+    /// Larger requests go to malloc.
+    /// An allocator must outlive the threads that used it.
+    /// </summary>
+    class PoolAllocator : public Allocator {
+    public:
+
+        static const size_t MAX_SIZE = 32768;
+
+        static const size_t ARENA_SIZE = 2 << 20;
+
+        static const int BATCH_BYTES = 1 << 16;
+
+        static const int MAX_BATCH = 32;
+
+        /// <summary>
+        /// Creates an empty pool (the arenas are reserved on demand)
+        /// </summary>
+        /// <param name="hugePages">The arenas are backed by huge pages, when the system provides them
+        /// (the allocator silently falls back to normal pages otherwise)</param>
+        explicit PoolAllocator(bool hugePages = false);
+
+        ~PoolAllocator();
+
+        void* allocate(size_t size)override;
+
+        void deallocate(void* p, size_t size)override;
+
+        AllocatorStatistics statistics()const override;
+
+        /// <summary>
+        /// Moves the blocks cached by the calling thread to the shared lists
+        /// </summary>
+        void flushThreadCache();
+
+        static int classOf(size_t size);
+
+        static size_t classSize(int c);
+
+        static int classCount();
+
+        struct ThreadCache;
+
+    private:
+
+        PoolAllocator(const PoolAllocator&);
+        PoolAllocator& operator=(const PoolAllocator&);
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Central {
+            std::mutex mutex;
+            FreeBlock* head = nullptr;
+        };
+
+        struct Arena {
+            void* base;
+            size_t size;
+            bool huge;
+        };
+
+        ThreadCache* cache();
+        int refill(int c, FreeBlock*& head);
+        void release(int c, FreeBlock* head, FreeBlock* tail);
+        void flush(ThreadCache* tc);
+        // counters of the threads that are served by another pool
+        void count(std::int64_t bytes, bool large);
+        char* carve(size_t bytes);
+        void attach(ThreadCache* tc);
+        void detach(ThreadCache* tc);
+
+        static int batchOf(int c);
+
+        bool m_huge;
+        std::vector<Central> m_central;
+        mutable std::mutex m_arenaMutex;
+        std::vector<Arena> m_arenas;
+        char* m_cur, * m_end;
+        mutable std::mutex m_cacheMutex;
+        std::vector<ThreadCache*> m_caches;
+        // counters of the detached thread caches
+        AllocatorStatistics m_retired;
+
+        friend struct ThreadCache;
+    };
+}
+
+#endif
@@ -3,6 +3,9 @@
 
 #include <algorithm>
 #include "matrix_0.h"
+#include "reductions.h"
+#include "copies.h"
+#include "scaling.h"
 
 namespace LCPP {
 
@@ -10,41 +13,75 @@ namespace LCPP {
     class IAMAX {
     public:
 
-        IAMAX() {}
+        /// <summary>
+        /// nthreads > 1 enables the multi-threaded search on long vectors
+        /// </summary>
+        IAMAX(int nthreads = 1) :m_nthreads(nthreads) {}
 
-        int operator()(int n, const T* x, int incx);
+        index_t operator()(index_t n, const T* x, index_t incx);
+
+    private:
+
+        int m_nthreads;
 
     };
 
     template<typename T>
-    int IAMAX<T>::operator()(int n, const T* x, int incx) {
+    index_t IAMAX<T>::operator()(index_t n, const T* x, index_t incx) {
         if (n < 1 || incx <= 0)
             return -1;
-        if (n == 1)
-            return 0;
-        int iamax = 0;
-        if (incx == 1) {
-            T amax = std::abs(x[0]);
-            for (int i = 1; i < n; ++i) {
-                T cur = std::abs(x[i]);
-                if (cur > amax) {
-                    amax = cur;
-                    iamax = i;
-                }
+        if (m_nthreads > 1)
+            return NUMCPP::Reductions<T>::iamax(n, x, incx, m_nthreads);
+        return NUMCPP::Reductions<T>::iamax(n, x, incx);
+    }
+
+    /// <summary>
+    /// Dot product x'y. The accumulation follows the mode given in the constructor
+    /// (plain loop, reproducible or compensated summation)
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    template <typename T>
+    class DOT {
+    public:
+
+        DOT(NUMCPP::Summation mode = NUMCPP::Summation::Fast) :m_mode(mode) {}
+
+        T operator()(index_t n, const T* x, index_t incx, const T* y, index_t incy);
+
+    private:
+
+        NUMCPP::Summation m_mode;
+
+    };
+
+    template<typename T>
+    T DOT<T>::operator()(index_t n, const T* x, index_t incx, const T* y, index_t incy) {
+        if (n <= 0)
+            return NUMCPP::CONSTANTS<T>::zero;
+        if (incx < 0)
+            x += (1 - n) * incx;
+        if (incy < 0)
+            y += (1 - n) * incy;
+        switch (m_mode) {
+        case NUMCPP::Summation::Reproducible:
+            return NUMCPP::Reductions<T>::rdot(n, x, incx, y, incy);
+        case NUMCPP::Summation::Compensated:
+            return NUMCPP::Reductions<T>::cdot(n, x, incx, y, incy);
+        default:
+            break;
+        }
+        T s = NUMCPP::CONSTANTS<T>::zero;
+        if (incx == 1 && incy == 1) {
+            for (index_t i = 0; i < n; ++i) {
+                s += x[i] * y[i];
             }
         }
         else {
-            T amax = std::abs(x[0]);
-            for (int i = 1, idx = 0; i < n; ++i) {
-                idx += incx;
-                T cur = std::abs(x[idx]);
-                if (cur > amax) {
-                    amax = cur;
-                    iamax = i;
-                }
+            for (index_t i = 0, ix = 0, iy = 0; i < n; ++i, ix += incx, iy += incy) {
+                s += x[ix] * y[iy];
             }
         }
-        return iamax;
+        return s;
     }
 
     template <typename T>
@@ -54,33 +91,19 @@ namespace LCPP {
 
         SWAP() {}
 
-        void operator()(int n, T* x, int incx, T* y, int incy);
+        void operator()(index_t n, T* x, index_t incx, T* y, index_t incy);
 
     };
 
     template<typename T>
-    void SWAP<T>::operator()(int n, T* x, int incx, T* y, int incy) {
+    void SWAP<T>::operator()(index_t n, T* x, index_t incx, T* y, index_t incy) {
         if (n <= 0)
             return;
-        if (incx == 1 && incy == 1) {
-            for (int i = 0; i < n; ++i) {
-                T tmp = x[i];
-                x[i] = y[i];
-                y[i] = tmp;
-            }
-        }
-        else {
-            int ix = 0, iy = 0;
-            if (incx < 0) ix = (-n + 1) * incx;
-            if (incy < 0) iy = (-n + 1) * incy;
-            for (int i = 0; i < n; ++i) {
-                T tmp = x[ix];
-                x[ix] = y[iy];
-                y[iy] = tmp;
-                ix += incx;
-                iy += incy;
-            }
-        }
+        if (incx < 0)
+            x += (1 - n) * incx;
+        if (incy < 0)
+            y += (1 - n) * incy;
+        NUMCPP::Copies<T>::swap(n, x, incx, y, incy);
     }
 
     template <typename T>
@@ -89,44 +112,15 @@ namespace LCPP {
 
         SCAL() {}
 
-        void operator()(int n, T a, T* x, int incx);
+        void operator()(index_t n, T a, T* x, index_t incx);
 
     };
 
     template <typename T>
-    void SCAL<T>::operator()(int n, T a, T* x, int incx) {
+    void SCAL<T>::operator()(index_t n, T a, T* x, index_t incx) {
         if (n <= 0 || incx <= 0)
             return;
-        T one = NUMCPP::CONSTANTS<T>::one;
-        if (a == one)
-            return;
-        T zero = NUMCPP::CONSTANTS<T>::zero;
-        if (incx == 1) {
-            if (a == zero) {
-                for (int i = 0; i < n; ++i) {
-                    x[i] = zero;
-                }
-            }
-            else {
-                for (int i = 0; i < n; ++i) {
-                    x[i] *= a;
-                }
-            }
-
-        }
-        else {
-            int imax = incx * n;
-            if (a == zero) {
-                for (int i = 0; i < imax; i += incx) {
-                    x[i] = zero;
-                }
-            }
-            else {
-                for (int i = 0; i < imax; i += incx) {
-                    x[i] *= a;
-                }
-            }
-        }
+        NUMCPP::Scaling<T>::scal(n, a, x, incx);
     }
 }
 
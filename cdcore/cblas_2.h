@@ -15,12 +15,12 @@ namespace LCPP {
 
 		GER() {}
 
-		void operator()(int m, int n, T alpha, const T* x, int incx, const T* y, int incy, T* A, int lda);
+		void operator()(index_t m, index_t n, T alpha, const T* x, index_t incx, const T* y, index_t incy, T* A, index_t lda);
 
 	};
 
     template <typename T>
-    void GER<T>::operator()(int m, int n, T alpha, const T* x, int incx, const T* y, int incy, T* A, int lda) {
+    void GER<T>::operator()(index_t m, index_t n, T alpha, const T* x, index_t incx, const T* y, index_t incy, T* A, index_t lda) {
         int info = 0;
         if (m < 0)
             info = 1;
@@ -30,38 +30,38 @@ namespace LCPP {
             info = 5;
         else if (incy == 0)
             info = 7;
-        else if (lda < std::max(1, m))
+        else if (lda < std::max<index_t>(1, m))
             info = 9;
         if (info != 0)
             throw lcpp_exception("ger", info);
         T zero = NUMCPP::CONSTANTS<T>::zero;
         if (m == 0 || n == 0 || alpha == zero)
             return;
-        int jy = 0;
+        index_t jy = 0;
         if (incy < 0)
             jy = incy * (n - 1);
         if (incx == 1) {
-            for (int j = 0; j < n; ++j, jy+=incy) {
+            for (index_t j = 0; j < n; ++j, jy+=incy) {
                 T ycur = y[jy];
                 if (ycur != zero) {
                     T tmp = alpha * ycur;
                     T* C = A + lda * j;
-                    for (int i = 0; i < m; ++i) {
+                    for (index_t i = 0; i < m; ++i) {
                         C[i] += x[i] * tmp;
                     }
                 }
             }
         }
         else {
-            int kx = 0;
+            index_t kx = 0;
             if (incx < 0)
                 kx = incx * (m - 1);
-            for (int j = 0; j < n; ++j, jy += incy) {
+            for (index_t j = 0; j < n; ++j, jy += incy) {
                 T ycur = y[jy];
                 if (ycur != zero) {
                     T tmp = alpha * ycur;
                     T* C = A + lda * j;
-                    for (int i = 0, ix=kx; i < m; ++i, ix+=incx) {
+                    for (index_t i = 0, ix=kx; i < m; ++i, ix+=incx) {
                         C[i] += x[ix] * tmp;
                     }
                 }
@@ -19,37 +19,37 @@ namespace LCPP {
 
         TRSM() {}
 
-        void operator()(Side side, Triangular uplo, bool tA, bool nounit, int m, int n, T alpha, const T* A, int lda, T* B, int ldb);
+        void operator()(Side side, Triangular uplo, bool tA, bool nounit, index_t m, index_t n, T alpha, const T* A, index_t lda, T* B, index_t ldb);
 
     private:
-        bool checkInput(Side side, int m, int n, int lda, int ldb);
+        bool checkInput(Side side, index_t m, index_t n, index_t lda, index_t ldb);
     };
 
     template<typename T>
-    bool TRSM<T>::checkInput(Side side, int m, int n, int lda, int ldb) {
-        int nrowa = (side == Side::Left) ? m : n;
+    bool TRSM<T>::checkInput(Side side, index_t m, index_t n, index_t lda, index_t ldb) {
+        index_t nrowa = (side == Side::Left) ? m : n;
         int info = 0;
         if (m < 0)
             info = 5;
         else if (n < 0)
             info = 6;
-        else if (lda < std::max(1, nrowa))
+        else if (lda < std::max<index_t>(1, nrowa))
             info = 9;
-        else if (ldb < std::max(1, m))
+        else if (ldb < std::max<index_t>(1, m))
             info = 11;
         if (info != 0)
             throw lcpp_exception("TRSM", info);
     }
     template<typename T>
-    void TRSM<T>::operator() (Side side, Triangular uplo, bool tA, bool nounit, int m, int n, T alpha, const T* A, int lda, T* B, int ldb) {
+    void TRSM<T>::operator() (Side side, Triangular uplo, bool tA, bool nounit, index_t m, index_t n, T alpha, const T* A, index_t lda, T* B, index_t ldb) {
         checkInput(side, m, n, lda, ldb);
         if (m == 0 || n == 0)
             return;
         T zero = NUMCPP::CONSTANTS<T>::zero;
         if (alpha == zero) {
             T* CBi = B;
-            for (int i = 0; i < n; ++i, CBi += ldb) {
-                for (int j = 0; j < m; ++j) {
+            for (index_t i = 0; i < n; ++i, CBi += ldb) {
+                for (index_t j = 0; j < m; ++j) {
                     CBi[j] = zero;
                 }
             }
@@ -63,18 +63,18 @@ namespace LCPP {
             if (!tA) {
                 //  A * X = alpha * B
                 if (uplo == Triangular::Upper) {
-                    for (int j = 0; j < n; ++j, Bj += ldb) {
+                    for (index_t j = 0; j < n; ++j, Bj += ldb) {
                         if (alpha != 1) {
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bj[i] *= alpha;
                             }
                             const T* Ak = CA_last;
-                            for (int k = m - 1; k >= 0; --k, Ak -= lda) {
+                            for (index_t k = m - 1; k >= 0; --k, Ak -= lda) {
                                 if (Bj[k] != zero) {
                                     if (nounit) {
                                         Bj[k] /= Ak[k];
                                     }
-                                    for (int i = 0; i < k - 1; ++i) {
+                                    for (index_t i = 0; i < k - 1; ++i) {
                                         Bj[i] -= Bj[k] * Ak[i];
                                     }
                                 }
@@ -83,20 +83,20 @@ namespace LCPP {
                     }
                 }
                 else {
-                    for (int j = 0; j < n; ++j, Bj += ldb) {
+                    for (index_t j = 0; j < n; ++j, Bj += ldb) {
                         if (alpha != 1) {
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bj[i] *= alpha;
                             }
                         }
-                        for (int k = 0; k < m; ++k) {
+                        for (index_t k = 0; k < m; ++k) {
 
                             if (Bj[k] != zero) {
                                 const T* Ak = A + k * lda;
                                 if (nounit) {
                                     Bj[k] /= Ak[k];
                                 }
-                                for (int i = k + 1; i < m; ++i) {
+                                for (index_t i = k + 1; i < m; ++i) {
                                     Bj[i] -= Bj[k] * Ak[i];
                                 }
                             }
@@ -108,11 +108,11 @@ namespace LCPP {
             else {
                 //  A' * X = alpha * B
                 if (uplo == Triangular::Upper) {
-                    for (int j = 1; j < n; ++j, Bj += ldb) {
+                    for (index_t j = 1; j < n; ++j, Bj += ldb) {
                         const T* Ai = A;
-                        for (int i = 0; i < m; ++i, Ai += lda) {
+                        for (index_t i = 0; i < m; ++i, Ai += lda) {
                             T tmp = alpha * Bj[i];
-                            for (int k = 0; k < i; ++k) {
+                            for (index_t k = 0; k < i; ++k) {
                                 tmp -= Ai[k] * Bj[k];
                             }
                             if (nouint)
@@ -122,11 +122,11 @@ namespace LCPP {
                     }
                 }
                 else {
-                    for (int j = 0; j < n ++j, CBj += ldb) {
+                    for (index_t j = 0; j < n ++j, CBj += ldb) {
                         const T* Ai = CA_last;
-                        for (int i = m - 1; i >= 0; --i, Ai -= lda) {
+                        for (index_t i = m - 1; i >= 0; --i, Ai -= lda) {
                             T tmp = alpha * Bj[i];
-                            for (int k = i + 1; k < m; ++k) {
+                            for (index_t k = i + 1; k < m; ++k) {
                                 tmp -= Ai[k] * Bj[k];
                             }
                             if (nounit)
@@ -143,23 +143,23 @@ namespace LCPP {
                 //  X * A = alpha * B or X = alpha * B * inv(A)
                 if (uplo == Triangular::Upper) {
                     T* Aj = A;
-                    for (int j = 0; j < n; ++j, Bj += ldb, Aj += lda) {
+                    for (index_t j = 0; j < n; ++j, Bj += ldb, Aj += lda) {
                         if (alpha != one) {
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bj[i] *= alpha;
                             }
                         }
                         T* Bk = B;
-                        for (int k = 0; k < j; ++k, Bk += ldb) {
+                        for (index_t k = 0; k < j; ++k, Bk += ldb) {
                             if (Aj[k] != zero) {
-                                for (int i = 0; i < m; ++i) {
+                                for (index_t i = 0; i < m; ++i) {
                                     Bj[i] -= Aj[k] * Bk[i];
                                 }
                             }
                         }
                         if (nounit) {
                             T tmp = one / Aj[j];
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bj[i] *= tmp;
                             }
                         }
@@ -168,22 +168,22 @@ namespace LCPP {
                 else {
                     T* Bj = CB_last;
                     const T* Aj = A + (n - 1) * lda;
-                    for (int j = n - 1; j >= 0; --j, Bj -= ldb, Aj -= lda) {
+                    for (index_t j = n - 1; j >= 0; --j, Bj -= ldb, Aj -= lda) {
                         if (alpha != one) {
-                            for (int i = 0; i < m; ++i)
+                            for (index_t i = 0; i < m; ++i)
                                 Bj[i] *= alpha;
                         }
                         T* Bk = Bj + ldb;
-                        for (int k = j + 1; k < n; ++k, Bk += ldb) {
+                        for (index_t k = j + 1; k < n; ++k, Bk += ldb) {
                             if (Aj[k]) != zero){
-                                for (int i = 0; i < m; ++i) {
+                                for (index_t i = 0; i < m; ++i) {
                                     Bj[i] -= Aj[k] * Bk[i];
                                 }
                             }
                         }
                         if (nounit) {
                             T tmp = one / Aj[j];
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bj[i] *= tmp;
                             }
                         }
@@ -195,24 +195,24 @@ namespace LCPP {
                 if (uplo == Triangular::Upper) {
                     const T* Ak = A + (n - 1) * lda;
                     T* Bk = B + (n - 1) * ldb;
-                    for (int k = n - 1; k >= 0; --k, Ak -= lda, Bk -= ldb) {
+                    for (index_t k = n - 1; k >= 0; --k, Ak -= lda, Bk -= ldb) {
                         if (nounit) {
                             T tmp = one / Ak[k];
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bk[i] *= tmp;
                             }
                         }
                         T* Bj = B;
-                        for (int j = 0; j < k; ++j, Bj += ldb) {
+                        for (index_t j = 0; j < k; ++j, Bj += ldb) {
                             if (Ak[j] != zero) {
                                 T tmp = Ak[j];
-                                for (int i = 0; i < m; ++i) {
+                                for (index_t i = 0; i < m; ++i) {
                                     Bj[i] -= tmp * Bk[i];
                                 }
                             }
                         }
                         if (alpha != one) {
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bj[i] *= alpha;
                             }
                         }
@@ -221,22 +221,22 @@ namespace LCPP {
                 else {
                     const T* Ak = A;
                     T* B = B;
-                    for (int k = 0; k < n; ++k, Ak += lda, B += ldb) {
+                    for (index_t k = 0; k < n; ++k, Ak += lda, B += ldb) {
                         if (nounit) {
                             T tmp = one / Ak[k];
-                            for (int i = 0; i < m; ++i)
+                            for (index_t i = 0; i < m; ++i)
                         }
                         T* Bj = Bk + ldb;
-                        for (int j = k + 1; j < n; ++j, Bj += ldb) {
+                        for (index_t j = k + 1; j < n; ++j, Bj += ldb) {
                             if (Ak[j] != zero) {
                                 T tmp = Ak[j];
-                                for (int i = 0; i < m; ++i) {
+                                for (index_t i = 0; i < m; ++i) {
                                     Bj[i] -= tmp * Bk[i];
                                 }
                             }
                         }
                         if (alpha != one) {
-                            for (int i = 0; i < m; ++i) {
+                            for (index_t i = 0; i < m; ++i) {
                                 Bk[i] *= alpha;
                             }
                         }
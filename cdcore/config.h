@@ -0,0 +1,55 @@
+#ifndef __numcpp_config_h
+#define __numcpp_config_h
+
+#include <cstdint>
+
+//****************************************************************************
+//
+//	Build options of the library
+//
+//	NUMCPP_INDEX64: lengths, increments and leading dimensions of the
+//	sequences, matrices and LCPP routines are 64-bit integers
+//	(required when a matrix holds more than 2^31 items)
+//
+//	NUMCPP_SMALLBLOCK_SIZE: number of items stored inline by SmallBlock
+//	(default 24); larger blocks are allocated on the heap
+//
+//	NUMCPP_ALIGNMENT: alignment (in bytes) of the heap blocks and of the
+//	vectors of rdvector.h (default 16, the alignment of the blocks of the
+//	allocators; a larger value adds up to NUMCPP_ALIGNMENT - 16 bytes of
+//	padding to each block)
+//
+//	NUMCPP_MALLOC: the vectors are allocated by malloc instead of the
+//	pooled allocator (see allocator.h)
+//
+//	NUMCPP_POLYNOMIAL_INLINE_DEGREE: maximal degree of the polynomials
+//	stored without heap allocation (default 32)
+//
+//	NUMCPP_SINGLE_THREADED: the reference counts of RefCount and of the
+//	shared vectors are not atomic (objects can't be shared between threads)
+//
+//****************************************************************************
+
+#ifndef NUMCPP_SMALLBLOCK_SIZE
+#define NUMCPP_SMALLBLOCK_SIZE 24
+#endif
+
+#ifndef NUMCPP_POLYNOMIAL_INLINE_DEGREE
+#define NUMCPP_POLYNOMIAL_INLINE_DEGREE 32
+#endif
+
+#ifndef NUMCPP_ALIGNMENT
+#define NUMCPP_ALIGNMENT 16
+#endif
+
+namespace NUMCPP {
+
+#ifdef NUMCPP_INDEX64
+	typedef std::int64_t index_t;
+#else
+	typedef int index_t;
+#endif
+
+}
+
+#endif
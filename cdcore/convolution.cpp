@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include "convolution.h"
+#include "fft.h"
+
+using namespace NUMCPP;
+
+namespace {
+
+	// Cost model of the algorithms, in units of one multiply-add of the schoolbook loop.
+	// The constants come from timings of the three algorithms on random operands
+	// (x86-64, g++ -O2): Karatsuba takes KARATSUBA_COST * n^log2(3) units for two blocks
+	// of n coefficients, the real FFT product FFT_COST * N log2(N) units for a transform of N.
+	const double KARATSUBA_COST = 3.5;
+	const double FFT_COST = 3.0;
+
+	// Dense schoolbook product (no test on the coefficients), out is not cleared
+	inline void accumulate(const double* a, int na, const double* b, int nb, double* out) {
+		for (int i = 0; i < na; ++i) {
+			double ai = a[i];
+			double* o = out + i;
+			for (int j = 0; j < nb; ++j)
+				o[j] += ai * b[j];
+		}
+	}
+}
+
+void Convolution::multiply(const double* a, int na, const double* b, int nb, double* out, Algorithm algorithm) {
+	if (na <= 0 || nb <= 0)
+		return;
+	if (algorithm == Auto)
+		algorithm = select(na, nb);
+	switch (algorithm) {
+	case Karatsuba:
+		karatsuba(a, na, b, nb, out);
+		break;
+	case Fft:
+		fft(a, na, b, nb, out);
+		break;
+	default:
+		schoolbook(a, na, b, nb, out);
+		break;
+	}
+}
+
+Convolution::Algorithm Convolution::select(int na, int nb) {
+	int s = std::min(na, nb), l = std::max(na, nb);
+	if (s < KARATSUBA_MIN)
+		return Schoolbook;
+	double school = double(s) * l;
+	double kara = std::ceil(double(l) / s) * KARATSUBA_COST * std::pow(double(s), 1.5849625007211562);
+	int N = FFT::powerOf2(na + nb - 1);
+	double fft = FFT_COST * N * std::log2(double(N));
+	if (school <= kara && school <= fft)
+		return Schoolbook;
+	return kara <= fft ? Karatsuba : Fft;
+}
+
+void Convolution::schoolbook(const double* a, int na, const double* b, int nb, double* out) {
+	int n = na + nb - 1;
+	std::fill(out, out + n, 0.0);
+	// the longest operand is in the inner loop
+	if (na > nb) {
+		std::swap(a, b);
+		std::swap(na, nb);
+	}
+	for (int i = 0; i < na; ++i) {
+		double ai = a[i];
+		if (ai != 0) {
+			double* o = out + i;
+			for (int j = 0; j < nb; ++j)
+				o[j] += ai * b[j];
+		}
+	}
+}
+
+void Convolution::karatsuba(const double* a, const double* b, int n, double* out, double* ws) {
+	if (n <= KARATSUBA_LEAF) {
+		std::fill(out, out + 2 * n - 1, 0.0);
+		accumulate(a, n, b, n, out);
+		return;
+	}
+	// a = a0 + x^m a1, b = b0 + x^m b1
+	// a*b = z0 + x^m ((a0+a1)(b0+b1) - z0 - z2) + x^2m z2, with z0 = a0 b0, z2 = a1 b1
+	int m = n / 2, h = n - m;
+	karatsuba(a, b, m, out, ws);
+	out[2 * m - 1] = 0;
+	karatsuba(a + m, b + m, h, out + 2 * m, ws);
+	double* s = ws, * t = ws + h, * z1 = ws + 2 * h;
+	for (int i = 0; i < m; ++i) {
+		s[i] = a[i] + a[m + i];
+		t[i] = b[i] + b[m + i];
+	}
+	if (h > m) {
+		s[m] = a[2 * m];
+		t[m] = b[2 * m];
+	}
+	karatsuba(s, t, h, z1, ws + 4 * h);
+	const double* z0 = out, * z2 = out + 2 * m;
+	for (int i = 0; i < 2 * m - 1; ++i)
+		z1[i] -= z0[i];
+	for (int i = 0; i < 2 * h - 1; ++i)
+		z1[i] -= z2[i];
+	double* o = out + m;
+	for (int i = 0; i < 2 * h - 1; ++i)
+		o[i] += z1[i];
+}
+
+void Convolution::karatsuba(const double* a, int na, const double* b, int nb, double* out) {
+	// the longest operand is split in blocks of the size of the shortest one
+	if (na < nb) {
+		std::swap(a, b);
+		std::swap(na, nb);
+	}
+	int s = nb, n = na + nb - 1;
+	std::vector<double> ws(4 * s + 128), block(s), prod(2 * s - 1);
+	std::fill(out, out + n, 0.0);
+	for (int c = 0; c < na; c += s) {
+		int len = std::min(s, na - c);
+		const double* ac = a + c;
+		if (len < s) {
+			std::copy(ac, ac + len, block.begin());
+			std::fill(block.begin() + len, block.end(), 0.0);
+			ac = block.data();
+		}
+		karatsuba(ac, b, s, prod.data(), ws.data());
+		int np = std::min(2 * s - 1, n - c);
+		double* o = out + c;
+		for (int i = 0; i < np; ++i)
+			o[i] += prod[i];
+	}
+}
+
+void Convolution::fft(const double* a, int na, const double* b, int nb, double* out) {
+	int n = na + nb - 1;
+	int N = std::max(2, FFT::powerOf2(n));
+	const RealFFT& plan = RealFFT::plan(N);
+	std::vector<double> x(N, 0.0), y(N, 0.0);
+	std::copy(a, a + na, x.begin());
+	std::copy(b, b + nb, y.begin());
+	std::vector<std::complex<double>> X(N / 2 + 1), Y(N / 2 + 1);
+	plan.forward(x.data(), X.data());
+	plan.forward(y.data(), Y.data());
+	for (int k = 0; k <= N / 2; ++k)
+		X[k] *= Y[k];
+	plan.inverse(X.data(), x.data());
+	std::copy(x.begin(), x.begin() + n, out);
+}
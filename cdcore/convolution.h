@@ -0,0 +1,52 @@
+#ifndef __numcpp_convolution_h
+#define __numcpp_convolution_h
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Products of polynomials (linear convolutions) of real coefficients:
+    /// out[k] = sum a[i] b[k-i], k in [0, na+nb-1[.
+    /// Three algorithms are available:
+    ///     Schoolbook: O(na*nb); the zero coefficients are skipped
+    ///     Karatsuba: O(n^1.585) on blocks of the size of the shortest operand
+    ///     Fft: O(N log N) with N the power of 2 above na+nb-1 (real FFT); the error
+    ///         is of the order of eps * log N * max|a| * max|b| * min(na, nb) on every item
+    /// Auto picks the cheapest one according to a cost model whose constants
+    /// were measured on x86-64 (see convolution.cpp).
+    /// </summary>
+    class Convolution {
+    public:
+
+        enum Algorithm {
+            Auto,
+            Schoolbook,
+            Karatsuba,
+            Fft
+        };
+
+        /// <summary>
+        /// out[0, na+nb-1[ = a * b. out must not overlap a or b.
+        /// </summary>
+        static void multiply(const double* a, int na, const double* b, int nb, double* out, Algorithm algorithm = Auto);
+
+        /// <summary>
+        /// Algorithm used by Auto for operands of na and nb coefficients
+        /// </summary>
+        static Algorithm select(int na, int nb);
+
+        // Size of the blocks that Karatsuba multiplies by the schoolbook method
+        static const int KARATSUBA_LEAF = 32;
+
+        // Minimal size of the shortest operand for Karatsuba and FFT
+        static const int KARATSUBA_MIN = 48;
+
+    private:
+
+        static void schoolbook(const double* a, int na, const double* b, int nb, double* out);
+        static void karatsuba(const double* a, int na, const double* b, int nb, double* out);
+        static void fft(const double* a, int na, const double* b, int nb, double* out);
+        static void karatsuba(const double* a, const double* b, int n, double* out, double* ws);
+    };
+}
+
+#endif
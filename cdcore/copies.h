@@ -0,0 +1,195 @@
+#ifndef __numcpp_copies_h
+#define __numcpp_copies_h
+
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <functional>
+#include "config.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Copy and swap kernels on strided arrays (x[0], x[incx], ..., x[(n-1)*incx]).
+    /// Contiguous copies go through memmove, which switches to non-temporal stores
+    /// on large blocks in the usual C runtimes; strided accesses are unrolled so
+    /// that several independent loads/stores are in flight.
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    template <typename T>
+    struct Copies {
+
+        /// <summary>
+        /// y[i*incy] = x[i*incx], i in [0, n[. x and y may overlap: contiguous arrays are
+        /// copied as by memmove (as through a temporary array); overlapping strided arrays
+        /// are copied item by item, in the increasing order of i.
+        /// </summary>
+        static void copy(index_t n, const T* x, index_t incx, T* y, index_t incy);
+
+        /// <summary>
+        /// Exchanges x[i*incx] and y[i*incy], i in [0, n[
+        /// </summary>
+        static void swap(index_t n, T* x, index_t incx, T* y, index_t incy);
+
+        /// <summary>
+        /// B = A' where A is m x n (leading dimension lda) and B is n x m (leading dimension ldb).
+        /// The matrices are processed by square tiles, so that both the reads and the writes
+        /// stay in cache.
+        /// </summary>
+        static void transpose(index_t m, index_t n, const T* A, index_t lda, T* B, index_t ldb);
+
+        static const int UNROLL = 4;
+
+        static const int TILE = 32;
+
+    private:
+
+        static void gather(index_t n, const T* x, index_t incx, T* y);
+        static void scatter(index_t n, const T* x, T* y, index_t incy);
+        static void strided(index_t n, const T* x, index_t incx, T* y, index_t incy);
+        static void ordered(index_t n, const T* x, index_t incx, T* y, index_t incy);
+
+        // true if the memory spanned by x[i*incx] and y[i*incy], i in [0, n[, overlap
+        static bool overlap(index_t n, const T* x, index_t incx, const T* y, index_t incy);
+    };
+
+    template <typename T>
+    void Copies<T>::copy(index_t n, const T* x, index_t incx, T* y, index_t incy) {
+        if (n <= 0 || (x == y && incx == incy))
+            return;
+        if (incx == 1 && incy == 1) {
+            if (std::is_trivially_copyable<T>::value)
+                std::memmove(static_cast<void*>(y), static_cast<const void*>(x), n * sizeof(T));
+            else if (std::less<const T*>()(x, y) && std::less<const T*>()(y, x + n))
+                std::copy_backward(x, x + n, y + n);
+            else
+                std::copy(x, x + n, y);
+        }
+        else if (overlap(n, x, incx, y, incy))
+            // the unrolled kernels read several items before writing them
+            ordered(n, x, incx, y, incy);
+        else if (incy == 1)
+            gather(n, x, incx, y);
+        else if (incx == 1)
+            scatter(n, x, y, incy);
+        else
+            strided(n, x, incx, y, incy);
+    }
+
+    template <typename T>
+    void Copies<T>::gather(index_t n, const T* x, index_t incx, T* y) {
+        index_t nu = (n / UNROLL) * UNROLL;
+        index_t i = 0;
+        const T* px = x;
+        index_t step = UNROLL * incx;
+        for (; i < nu; i += UNROLL, px += step) {
+            T x0 = px[0], x1 = px[incx], x2 = px[2 * incx], x3 = px[3 * incx];
+            y[i] = x0;
+            y[i + 1] = x1;
+            y[i + 2] = x2;
+            y[i + 3] = x3;
+        }
+        for (; i < n; ++i, px += incx)
+            y[i] = *px;
+    }
+
+    template <typename T>
+    void Copies<T>::scatter(index_t n, const T* x, T* y, index_t incy) {
+        index_t nu = (n / UNROLL) * UNROLL;
+        index_t i = 0;
+        T* py = y;
+        index_t step = UNROLL * incy;
+        for (; i < nu; i += UNROLL, py += step) {
+            T x0 = x[i], x1 = x[i + 1], x2 = x[i + 2], x3 = x[i + 3];
+            py[0] = x0;
+            py[incy] = x1;
+            py[2 * incy] = x2;
+            py[3 * incy] = x3;
+        }
+        for (; i < n; ++i, py += incy)
+            *py = x[i];
+    }
+
+    template <typename T>
+    void Copies<T>::strided(index_t n, const T* x, index_t incx, T* y, index_t incy) {
+        index_t nu = (n / UNROLL) * UNROLL;
+        index_t i = 0;
+        const T* px = x;
+        T* py = y;
+        index_t xstep = UNROLL * incx, ystep = UNROLL * incy;
+        for (; i < nu; i += UNROLL, px += xstep, py += ystep) {
+            T x0 = px[0], x1 = px[incx], x2 = px[2 * incx], x3 = px[3 * incx];
+            py[0] = x0;
+            py[incy] = x1;
+            py[2 * incy] = x2;
+            py[3 * incy] = x3;
+        }
+        for (; i < n; ++i, px += incx, py += incy)
+            *py = *px;
+    }
+
+    template <typename T>
+    void Copies<T>::ordered(index_t n, const T* x, index_t incx, T* y, index_t incy) {
+        for (index_t i = 0; i < n; ++i, x += incx, y += incy)
+            *y = *x;
+    }
+
+    template <typename T>
+    bool Copies<T>::overlap(index_t n, const T* x, index_t incx, const T* y, index_t incy) {
+        const T* x0 = incx < 0 ? x + (n - 1) * incx : x;
+        const T* x1 = incx < 0 ? x : x + (n - 1) * incx;
+        const T* y0 = incy < 0 ? y + (n - 1) * incy : y;
+        const T* y1 = incy < 0 ? y : y + (n - 1) * incy;
+        std::less<const T*> lt;
+        return !lt(x1, y0) && !lt(y1, x0);
+    }
+
+    template <typename T>
+    void Copies<T>::swap(index_t n, T* x, index_t incx, T* y, index_t incy) {
+        if (n <= 0 || (x == y && incx == incy))
+            return;
+        if (incx == 1 && incy == 1) {
+            std::swap_ranges(x, x + n, y);
+            return;
+        }
+        index_t nu = (n / UNROLL) * UNROLL;
+        index_t i = 0;
+        T* px = x, * py = y;
+        index_t xstep = UNROLL * incx, ystep = UNROLL * incy;
+        for (; i < nu; i += UNROLL, px += xstep, py += ystep) {
+            T x0 = px[0], x1 = px[incx], x2 = px[2 * incx], x3 = px[3 * incx];
+            T y0 = py[0], y1 = py[incy], y2 = py[2 * incy], y3 = py[3 * incy];
+            px[0] = y0;
+            px[incx] = y1;
+            px[2 * incx] = y2;
+            px[3 * incx] = y3;
+            py[0] = x0;
+            py[incy] = x1;
+            py[2 * incy] = x2;
+            py[3 * incy] = x3;
+        }
+        for (; i < n; ++i, px += incx, py += incy) {
+            T tmp = *px;
+            *px = *py;
+            *py = tmp;
+        }
+    }
+
+    template <typename T>
+    void Copies<T>::transpose(index_t m, index_t n, const T* A, index_t lda, T* B, index_t ldb) {
+        for (index_t c0 = 0; c0 < n; c0 += TILE) {
+            index_t c1 = std::min(n, c0 + TILE);
+            for (index_t r0 = 0; r0 < m; r0 += TILE) {
+                index_t r1 = std::min(m, r0 + TILE);
+                for (index_t c = c0; c < c1; ++c) {
+                    const T* a = A + c * lda;
+                    T* b = B + c;
+                    for (index_t r = r0; r < r1; ++r)
+                        b[r * ldb] = a[r];
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef __numcpp_expressions_h
+#define __numcpp_expressions_h
+
+#include <type_traits>
+#include <cassert>
+#include "sequence.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Lazy element-wise expressions on sequences (expression templates).
+    /// Operators on Sequence/DataBlock/scalars build a tree of nodes; nothing is
+    /// computed until the expression is assigned to a Sequence or a DataBlock,
+    /// which is done in a single loop:
+    ///     x = a * y + b * z - w;  // one pass, no temporary
+    /// The items of the target may appear in the expression at the same position only
+    /// (x = x * a + y is fine; x = x.drop(1, 0) + y is not). A DataBlock assigned an expression
+    /// of another length gets new storage: the expression may then read any of its items
+    /// (b = b.all().extract(0, n) * 2 is fine).
+    /// </summary>
+    /// <typeparam name="E">Type of the node (CRTP)</typeparam>
+    template <class E>
+    struct Expression {
+
+        const E& self()const {
+            return static_cast<const E&>(*this);
+        }
+    };
+
+    namespace EXPR {
+
+        /// <summary>
+        /// Leaf referencing the items of a sequence
+        /// </summary>
+        template <typename T>
+        struct Leaf : public Expression<Leaf<T>> {
+
+            typedef T value_type;
+
+            Leaf(const T* data, index_t n, index_t inc) :m_data(data), m_n(n), m_inc(inc) {}
+
+            // i-th item
+            T at(index_t i)const { return m_data[i * m_inc]; }
+            // i-th item, when all the leaves are contiguous
+            T atc(index_t i)const { return m_data[i]; }
+            bool contiguous()const { return m_inc == 1; }
+            index_t length()const { return m_n; }
+
+        private:
+            const T* m_data;
+            index_t m_n, m_inc;
+        };
+
+        template <typename T>
+        struct Scalar : public Expression<Scalar<T>> {
+
+            typedef T value_type;
+
+            Scalar(T value) :m_value(value) {}
+
+            T at(index_t)const { return m_value; }
+            T atc(index_t)const { return m_value; }
+            bool contiguous()const { return true; }
+            // undefined length
+            index_t length()const { return -1; }
+
+        private:
+            T m_value;
+        };
+
+        struct Add {
+            template <typename T>
+            static T apply(T l, T r) { return l + r; }
+        };
+
+        struct Sub {
+            template <typename T>
+            static T apply(T l, T r) { return l - r; }
+        };
+
+        struct Mul {
+            template <typename T>
+            static T apply(T l, T r) { return l * r; }
+        };
+
+        struct Div {
+            template <typename T>
+            static T apply(T l, T r) { return l / r; }
+        };
+
+        template <class Op, class L, class R>
+        struct Binary : public Expression<Binary<Op, L, R>> {
+
+            typedef typename L::value_type value_type;
+
+            Binary(const L& l, const R& r) :m_l(l), m_r(r) {
+                assert(l.length() < 0 || r.length() < 0 || l.length() == r.length());
+            }
+
+            value_type at(index_t i)const { return Op::apply(m_l.at(i), m_r.at(i)); }
+            value_type atc(index_t i)const { return Op::apply(m_l.atc(i), m_r.atc(i)); }
+            bool contiguous()const { return m_l.contiguous() && m_r.contiguous(); }
+            index_t length()const { return m_l.length() >= 0 ? m_l.length() : m_r.length(); }
+
+        private:
+            L m_l;
+            R m_r;
+        };
+
+        template <class E>
+        struct Negate : public Expression<Negate<E>> {
+
+            typedef typename E::value_type value_type;
+
+            Negate(const E& e) :m_e(e) {}
+
+            value_type at(index_t i)const { return -m_e.at(i); }
+            value_type atc(index_t i)const { return -m_e.atc(i); }
+            bool contiguous()const { return m_e.contiguous(); }
+            index_t length()const { return m_e.length(); }
+
+        private:
+            E m_e;
+        };
+
+        /// <summary>
+        /// Conversion of the operands into nodes
+        /// </summary>
+        template <class X>
+        struct Node {
+            static const bool valid = false;
+        };
+
+        template <typename T>
+        struct Node<Sequence<T>> {
+            static const bool valid = true;
+            typedef T value_type;
+            typedef Leaf<T> type;
+            static type make(const Sequence<T>& s) { return type(s.cstart(), s.length(), s.increment()); }
+        };
+
+        template <typename T>
+        struct Node<DataBlock<T>> {
+            static const bool valid = true;
+            typedef T value_type;
+            typedef Leaf<T> type;
+            static type make(const DataBlock<T>& s) { return type(s.all().cstart(), s.length(), 1); }
+        };
+
+        template <class Op, class L, class R>
+        struct Node<Binary<Op, L, R>> {
+            static const bool valid = true;
+            typedef typename L::value_type value_type;
+            typedef Binary<Op, L, R> type;
+            static const type& make(const type& e) { return e; }
+        };
+
+        template <class E>
+        struct Node<Negate<E>> {
+            static const bool valid = true;
+            typedef typename E::value_type value_type;
+            typedef Negate<E> type;
+            static const type& make(const type& e) { return e; }
+        };
+
+        template <class L, class R>
+        using EnableBoth = typename std::enable_if<Node<L>::valid&& Node<R>::valid,
+            typename Node<L>::value_type>::type;
+
+        template <class X>
+        using ValueOf = typename std::enable_if<Node<X>::valid, typename Node<X>::value_type>::type;
+
+        template <class Op, class L, class R>
+        inline Binary<Op, typename Node<L>::type, typename Node<R>::type> binary(const L& l, const R& r) {
+            return Binary<Op, typename Node<L>::type, typename Node<R>::type>(Node<L>::make(l), Node<R>::make(r));
+        }
+
+        template <class Op, class L>
+        inline Binary<Op, typename Node<L>::type, Scalar<ValueOf<L>>> binary(const L& l, ValueOf<L> r) {
+            return Binary<Op, typename Node<L>::type, Scalar<ValueOf<L>>>(Node<L>::make(l), Scalar<ValueOf<L>>(r));
+        }
+
+        template <class Op, class R>
+        inline Binary<Op, Scalar<ValueOf<R>>, typename Node<R>::type> binary(ValueOf<R> l, const R& r) {
+            return Binary<Op, Scalar<ValueOf<R>>, typename Node<R>::type>(Scalar<ValueOf<R>>(l), Node<R>::make(r));
+        }
+
+        /// <summary>
+        /// x[i*incx] = e(i), i in [0, n[, in one loop (vectorizable when everything is contiguous)
+        /// </summary>
+        template <typename T, class E>
+        void evaluate(T* x, index_t n, index_t incx, const E& e) {
+            assert(e.length() < 0 || e.length() == n);
+            if (incx == 1 && e.contiguous()) {
+                for (index_t i = 0; i < n; ++i)
+                    x[i] = e.atc(i);
+            }
+            else {
+                for (index_t i = 0; i < n; ++i)
+                    x[i * incx] = e.at(i);
+            }
+        }
+    }
+
+#define NUMCPP_EXPR_OPERATOR(OP, NAME) \
+    template <class L, class R, class = EXPR::EnableBoth<L, R>> \
+    inline auto operator OP(const L& l, const R& r) { return EXPR::binary<EXPR::NAME>(l, r); } \
+    template <class L, class = EXPR::ValueOf<L>> \
+    inline auto operator OP(const L& l, EXPR::ValueOf<L> r) { return EXPR::binary<EXPR::NAME, L>(l, r); } \
+    template <class R, class = EXPR::ValueOf<R>> \
+    inline auto operator OP(EXPR::ValueOf<R> l, const R& r) { return EXPR::binary<EXPR::NAME, R>(l, r); }
+
+    NUMCPP_EXPR_OPERATOR(+, Add)
+    NUMCPP_EXPR_OPERATOR(-, Sub)
+    NUMCPP_EXPR_OPERATOR(*, Mul)
+    NUMCPP_EXPR_OPERATOR(/ , Div)
+
+#undef NUMCPP_EXPR_OPERATOR
+
+    template <class E, class = EXPR::ValueOf<E>>
+    inline EXPR::Negate<typename EXPR::Node<E>::type> operator-(const E& e) {
+        return EXPR::Negate<typename EXPR::Node<E>::type>(EXPR::Node<E>::make(e));
+    }
+
+    template <typename T>
+    template <class E>
+    const Sequence<T>& Sequence<T>::operator=(const Expression<E>& expr)const {
+        EXPR::evaluate(m_data, m_n, m_inc, expr.self());
+        return *this;
+    }
+
+    template <typename T>
+    template <class E>
+    const Sequence<T>& Sequence<T>::operator+=(const Expression<E>& expr)const {
+        EXPR::evaluate(m_data, m_n, m_inc, *this + expr.self());
+        return *this;
+    }
+
+    template <typename T>
+    template <class E>
+    const Sequence<T>& Sequence<T>::operator-=(const Expression<E>& expr)const {
+        EXPR::evaluate(m_data, m_n, m_inc, *this - expr.self());
+        return *this;
+    }
+
+    template <typename T>
+    template <class E>
+    DataBlock<T>::DataBlock(const Expression<E>& expr) {
+        m_size = expr.self().length();
+        m_data = new T[m_size];
+        EXPR::evaluate(m_data, m_size, 1, expr.self());
+    }
+
+    template <typename T>
+    template <class E>
+    DataBlock<T>& DataBlock<T>::operator=(const Expression<E>& expr) {
+        index_t n = expr.self().length();
+        if (n != m_size) {
+            // the expression may read the current items: they are released after the evaluation
+            T* data = new T[n];
+            EXPR::evaluate(data, n, 1, expr.self());
+            delete[] m_data;
+            m_data = data;
+            m_size = n;
+        }
+        else {
+            EXPR::evaluate(m_data, m_size, 1, expr.self());
+        }
+        return *this;
+    }
+}
+
+#endif
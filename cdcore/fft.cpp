@@ -0,0 +1,155 @@
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "fft.h"
+
+using namespace NUMCPP;
+
+namespace {
+
+	const double TWOPI = 6.283185307179586476925286766559;
+
+	// (a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re) without the NaN/inf handling of std::complex
+	inline std::complex<double> cmul(const std::complex<double>& a, const std::complex<double>& b) {
+		return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+	}
+
+	template <class P>
+	const P& cachedPlan(int n) {
+		static std::mutex mutex;
+		static std::map<int, std::unique_ptr<P>> plans;
+		std::lock_guard<std::mutex> lock(mutex);
+		std::unique_ptr<P>& plan = plans[n];
+		if (!plan)
+			plan.reset(new P(n));
+		return *plan;
+	}
+}
+
+int FFT::powerOf2(int n) {
+	int p = 1;
+	while (p < n)
+		p <<= 1;
+	return p;
+}
+
+const std::vector<std::complex<double>>& FFT::twiddles(int n) {
+	static std::mutex mutex;
+	static std::map<int, std::vector<std::complex<double>>> tables;
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<std::complex<double>>& table = tables[n];
+	if (table.empty()) {
+		table.resize(n);
+		for (int k = 0; k < n; ++k) {
+			double a = -TWOPI * k / n;
+			table[k] = std::complex<double>(std::cos(a), std::sin(a));
+		}
+	}
+	return table;
+}
+
+FFT::FFT(int n) :m_n(n), m_rev(n), m_w(n / 2) {
+	int lg = 0;
+	while ((1 << lg) < n)
+		++lg;
+	for (int i = 0; i < n; ++i) {
+		int r = 0;
+		for (int b = 0; b < lg; ++b)
+			if (i & (1 << b))
+				r |= 1 << (lg - 1 - b);
+		m_rev[i] = r;
+	}
+	for (int k = 0; k < n / 2; ++k) {
+		double a = -TWOPI * k / n;
+		m_w[k] = std::complex<double>(std::cos(a), std::sin(a));
+	}
+}
+
+const FFT& FFT::plan(int n) {
+	return cachedPlan<FFT>(n);
+}
+
+void FFT::forward(std::complex<double>* x)const {
+	transform(x, false);
+}
+
+void FFT::inverse(std::complex<double>* x)const {
+	transform(x, true);
+	double s = 1.0 / m_n;
+	for (int i = 0; i < m_n; ++i)
+		x[i] *= s;
+}
+
+void FFT::transform(std::complex<double>* x, bool inverse)const {
+	int n = m_n;
+	for (int i = 0; i < n; ++i) {
+		int r = m_rev[i];
+		if (i < r)
+			std::swap(x[i], x[r]);
+	}
+	for (int len = 2; len <= n; len <<= 1) {
+		int half = len >> 1, step = n / len;
+		for (int i = 0; i < n; i += len) {
+			std::complex<double>* x0 = x + i, * x1 = x0 + half;
+			for (int j = 0, k = 0; j < half; ++j, k += step) {
+				std::complex<double> w = inverse ? std::conj(m_w[k]) : m_w[k];
+				std::complex<double> u = x0[j], v = cmul(x1[j], w);
+				x0[j] = u + v;
+				x1[j] = u - v;
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+RealFFT::RealFFT(int n) :m_n(n), m_half(FFT::plan(n / 2)), m_w(n / 2) {
+	for (int k = 0; k < n / 2; ++k) {
+		double a = -TWOPI * k / n;
+		m_w[k] = std::complex<double>(std::cos(a), std::sin(a));
+	}
+}
+
+const RealFFT& RealFFT::plan(int n) {
+	return cachedPlan<RealFFT>(n);
+}
+
+void RealFFT::forward(const double* x, std::complex<double>* X)const {
+	int m = m_n / 2;
+	// z[j] = x[2j] + i x[2j+1], stored in X[0, m[
+	for (int j = 0; j < m; ++j)
+		X[j] = std::complex<double>(x[2 * j], x[2 * j + 1]);
+	m_half.forward(X);
+	// X[k] = E[k] + w^k O[k], with E (O) the transform of the even (odd) items:
+	// E[k] = (Z[k] + conj(Z[m-k]))/2, O[k] = (Z[k] - conj(Z[m-k]))/2i
+	std::complex<double> z0 = X[0];
+	X[0] = std::complex<double>(z0.real() + z0.imag(), 0);
+	X[m] = std::complex<double>(z0.real() - z0.imag(), 0);
+	for (int k = 1, l = m - 1; k <= l; ++k, --l) {
+		std::complex<double> zk = X[k], zl = std::conj(X[l]);
+		std::complex<double> ek = 0.5 * (zk + zl), ok = std::complex<double>(0, -0.5) * (zk - zl);
+		std::complex<double> el = std::conj(ek), ol = std::conj(ok);
+		std::complex<double> wk = cmul(m_w[k], ok);
+		// w^(m-k) = -conj(w^k)
+		std::complex<double> wl = -cmul(std::conj(m_w[k]), ol);
+		X[k] = ek + wk;
+		X[l] = el + wl;
+	}
+}
+
+void RealFFT::inverse(const std::complex<double>* X, double* x)const {
+	int m = m_n / 2;
+	std::vector<std::complex<double>> z(m);
+	// E[k] = (X[k] + conj(X[m-k]))/2, O[k] = (X[k] - conj(X[m-k])) conj(w^k)/2, Z[k] = E[k] + i O[k]
+	for (int k = 0; k < m; ++k) {
+		std::complex<double> xk = X[k], xl = std::conj(X[m - k]);
+		std::complex<double> ek = 0.5 * (xk + xl), ok = cmul(0.5 * (xk - xl), std::conj(m_w[k]));
+		z[k] = ek + std::complex<double>(-ok.imag(), ok.real());
+	}
+	m_half.inverse(z.data());
+	for (int j = 0; j < m; ++j) {
+		x[2 * j] = z[j].real();
+		x[2 * j + 1] = z[j].imag();
+	}
+}
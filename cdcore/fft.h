@@ -0,0 +1,91 @@
+#ifndef __numcpp_fft_h
+#define __numcpp_fft_h
+
+#include <complex>
+#include <vector>
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Radix-2 fast Fourier transform of a fixed size (power of 2).
+    /// forward: X[k] = sum x[j] exp(-2 i pi jk/n); inverse: x[j] = 1/n sum X[k] exp(2 i pi jk/n).
+    /// The plans are immutable, so that a plan can be used by several threads.
+    /// </summary>
+    class FFT {
+    public:
+
+        explicit FFT(int n);
+
+        int size()const {
+            return m_n;
+        }
+
+        /// <summary>
+        /// In-place transforms of x[0, n[
+        /// </summary>
+        void forward(std::complex<double>* x)const;
+
+        void inverse(std::complex<double>* x)const;
+
+        /// <summary>
+        /// Shared plan of size n (power of 2), created on the first request
+        /// </summary>
+        static const FFT& plan(int n);
+
+        /// <summary>
+        /// Smallest power of 2 greater or equal to n
+        /// </summary>
+        static int powerOf2(int n);
+
+        /// <summary>
+        /// Shared table of exp(-2 i pi k/n), k in [0, n[ (any n >= 1), created on the first request
+        /// </summary>
+        static const std::vector<std::complex<double>>& twiddles(int n);
+
+    private:
+
+        void transform(std::complex<double>* x, bool inverse)const;
+
+        int m_n;
+        // bit-reversal permutation and exp(-2 i pi k/n), k in [0, n/2[
+        std::vector<int> m_rev;
+        std::vector<std::complex<double>> m_w;
+    };
+
+    /// <summary>
+    /// Fourier transform of real sequences of length n (power of 2, n >= 2),
+    /// computed by a complex FFT of length n/2 on the even/odd items packed
+    /// in the real/imaginary parts. The transform of a real sequence is hermitian,
+    /// so that only the items [0, n/2] are stored.
+    /// </summary>
+    class RealFFT {
+    public:
+
+        explicit RealFFT(int n);
+
+        int size()const {
+            return m_n;
+        }
+
+        /// <summary>
+        /// X[0, n/2] = transform of x[0, n[
+        /// </summary>
+        void forward(const double* x, std::complex<double>* X)const;
+
+        /// <summary>
+        /// x[0, n[ = inverse transform of the hermitian sequence defined by X[0, n/2]
+        /// </summary>
+        void inverse(const std::complex<double>* X, double* x)const;
+
+        static const RealFFT& plan(int n);
+
+    private:
+
+        int m_n;
+        const FFT& m_half;
+        // exp(-2 i pi k/n), k in [0, n/2[
+        std::vector<std::complex<double>> m_w;
+    };
+}
+
+#endif
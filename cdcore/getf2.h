@@ -38,7 +38,7 @@ namespace LCPP {
 
         void operator()(NUMCPP::FastMatrix<T> A, NUMCPP::Sequence<T> pivots);
 
-        void operator() (int m, int n, T* A, int lda, int* piv);
+        void operator() (index_t m, index_t n, T* A, index_t lda, index_t* piv);
 
         int info() {
             return m_info;
@@ -55,7 +55,7 @@ namespace LCPP {
         m_info = 0;
         if (A.isEmpty())
             return;
-        int m = A.getNrows(), n = A.getNcols();
+        index_t m = A.getNrows(), n = A.getNcols();
         if (m == 1) {
             pivots(0) = 0;
             if (A(0, 0) == 0)
@@ -67,7 +67,7 @@ namespace LCPP {
             T zero = NUMCPP::CONSTANTS<T>::zero, one = NUMCPP::CONSTANTS<T>::one;
             // Find pivot and test for singularity
             NUMCPP::Sequence<T>col = A.column(0);
-            int imax = col.imax();
+            index_t imax = col.imax();
             pivots(0) = imax;
             T cmax = col(imax);
             if (cmax != zero) {
@@ -83,8 +83,8 @@ namespace LCPP {
         }
         else {
             // recursive code
-            int n1 = std::min(m, n) / 2;
-            int n2 = n - n1;
+            index_t n1 = std::min(m, n) / 2;
+            index_t n2 = n - n1;
             GETF2<T> rgtrf2;
             NUMCPP::FastMatrix A1 = A.left(n1);
             rgtrf2(A1, pivots.left(n1));
@@ -94,30 +94,28 @@ namespace LCPP {
     }
 
     template<typename T>
-    void GETF2<T>::operator() (int m, int n, T* A, int lda, int* piv) {
+    void GETF2<T>::operator() (index_t m, index_t n, T* A, index_t lda, index_t* piv) {
         m_info = 0;
         if (m < 0)
             m_info = -1;
         else if (n < 0)
             m_info = -2;
-        else if (lda < std::max(1, m))
+        else if (lda < std::max<index_t>(1, m))
             m_info = -4;
         if (m_info != 0)
             throw lcpp_exception("getrf2", m_info);
         if (m == 0 || n == 0)
             return;
-        T sfmin = NUMCPP::CONSTANTS<T>::safe_min;
         T zero = NUMCPP::CONSTANTS<T>::zero;
         T one = NUMCPP::CONSTANTS<T>::one;
         IAMAX<T> iamax;
         SWAP<T> swap;
         GER<T> ger;
-        SCAL<T> scal;
-        int jmax = std::min(m, n);
+        index_t jmax = std::min(m, n);
         T* C = A;
-        for (int j = 0; j < jmax; ++j, C += lda) {
+        for (index_t j = 0; j < jmax; ++j, C += lda) {
             // Find pivot and test for singularity.
-            int jp = j + iamax(m - j, C + j, 1);
+            index_t jp = j + iamax(m - j, C + j, 1);
             piv[j] = jp;
             if (C[jp] != zero) {
                 // Apply the interchange to columns 1:N.
@@ -126,15 +124,8 @@ namespace LCPP {
                 }
                 // Compute elements J+1:M of J - th column.
                 if (j < m - 1) {
-                    T cj = C[j];
-                    if (std::abs(cj) >= sfmin) {
-                        scal(m - j - 1, one / cj, C + (j + 1), 1);
-                    }
-                    else {
-                        for (int i = 1; i < m - j; ++i) {
-                            C[j + i] /= cj;
-                        }
-                    }
+                    // reciprocal multiplication when |C[j]| >= sfmin, exact division otherwise
+                    NUMCPP::Scaling<T>::div(m - j - 1, C[j], C + (j + 1), 1);
                 }
             }
             else {
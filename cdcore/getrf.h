@@ -36,8 +36,8 @@ namespace LCPP {
 	void GETRF<T>::operator()(NUMCPP::FastMatrix<T> A, NUMCPP::Sequence<T> pivots) {
 		if (A.isEmpty())
 			return;
-		int m = A.getNrows(), n = A.getNcols;
-		int nb = blockSize(m, n);
+		index_t m = A.getNrows(), n = A.getNcols;
+		index_t nb = blockSize(m, n);
 		GETRF2<T> getrf2;
 		if (BLOCKSIZE > std::min(m, n)) {
 			getrf2(A, pivots);
@@ -36,7 +36,7 @@ namespace LCPP {
 
         void operator()(NUMCPP::FastMatrix<T> A, NUMCPP::Sequence<T> pivots);
 
-        void operator() (int m, int n, T* A, int lda, int* piv);
+        void operator() (index_t m, index_t n, T* A, index_t lda, index_t* piv);
 
         int info() {
             return m_info;
@@ -53,7 +53,7 @@ namespace LCPP {
         m_info = 0;
         if (A.isEmpty())
             return;
-        int m = A.getNrows(), n = A.getNcols();
+        index_t m = A.getNrows(), n = A.getNcols();
         if (m == 1) {
             pivots(0) = 0;
             if (A(0, 0) == 0)
@@ -65,7 +65,7 @@ namespace LCPP {
             T zero = NUMCPP::CONSTANTS<T>::zero, one = NUMCPP::CONSTANTS<T>::one;
             // Find pivot and test for singularity
             NUMCPP::Sequence<T>col = A.column(0);
-            int imax = col.imax();
+            index_t imax = col.imax();
             pivots(0) = imax;
             T cmax = col(imax);
             if (cmax != zero) {
@@ -81,8 +81,8 @@ namespace LCPP {
         }
         else {
             // recursive code
-            int n1 = std::min(m, n) / 2;
-            int n2 = n - n1;
+            index_t n1 = std::min(m, n) / 2;
+            index_t n2 = n - n1;
             GETRF2<T> rgtrf2;
             NUMCPP::FastMatrix A1=A.left(n1);
             rgtrf2(A1, pivots.left(n1));
@@ -92,13 +92,13 @@ namespace LCPP {
     }
 
     template<typename T>
-    void GETRF2<T>::operator() (int m, int n, T* A, int lda, int* piv ) {
+    void GETRF2<T>::operator() (index_t m, index_t n, T* A, index_t lda, index_t* piv ) {
         m_info = 0;
         if (m < 0)
             m_info = -1;
         else if (n < 0)
             m_info = -2;
-        else if (lda < std::max(1, m))
+        else if (lda < std::max<index_t>(1, m))
             m_info = -4;
         if (m_info != 0)
             throw std::exception();
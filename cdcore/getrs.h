@@ -17,7 +17,7 @@ namespace LCPP {
 
         GETRS() {}
 
-        void operator()(bool tA, int n, int nrhs, const T* A, int lda, int* piv, T* B, int ldb);
+        void operator()(bool tA, index_t n, index_t nrhs, const T* A, index_t lda, index_t* piv, T* B, index_t ldb);
  
         int info() {
             return m_info;
@@ -30,15 +30,15 @@ namespace LCPP {
 
     
     template <typename T>
-    void GETRS<T>::operator()(bool tA, int n, int nrhs, const T* A, int lda, int* piv, T* B, int ldb) {
+    void GETRS<T>::operator()(bool tA, index_t n, index_t nrhs, const T* A, index_t lda, index_t* piv, T* B, index_t ldb) {
         int info = 0;
         if (n < 0)
             info = -2;
         else if (nrhs < 0)
             info = -3;
-        else if (lda < std::max(1, n))
+        else if (lda < std::max<index_t>(1, n))
             info = -5;
-        else if (ldb < std::max(1, n))
+        else if (ldb < std::max<index_t>(1, n))
             info = -8;
         if (info != 0)
             throw lcpp_exception("DGETRS", -info);
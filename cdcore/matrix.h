@@ -11,25 +11,28 @@ namespace NUMCPP {
 	template<typename T>
 	class Matrix;
 
+	template<typename T>
+	class SharedMatrix;
+
 	template <typename T>
 	struct FastMatrix
 	{
 
-		T& operator()(int r, int c)const {
+		T& operator()(index_t r, index_t c)const {
 			return m_data[r + m_ldim * c];
 		}
 
 		~FastMatrix() {}
 
-		int getNrows() const{
+		index_t getNrows() const{
 			return m_nrows;
 		}
 
-		int getNcols() const{
+		index_t getNcols() const{
 			return m_ncols;
 		}
 
-		int getColumnIncrement() const{
+		index_t getColumnIncrement() const{
 			return m_ldim;
 		}
 
@@ -41,21 +44,21 @@ namespace NUMCPP {
 			return m_data;
 		}
 
-		Sequence<T> row(int row) const {
+		Sequence<T> row(index_t row) const {
 			return Sequence<T>(m_data + row, m_data + row + m_ldim * m_ncols, m_ldim);
 		}
 
-		Sequence<T> column(int col) const {
-			int start = col * m_ldim;
+		Sequence<T> column(index_t col) const {
+			index_t start = col * m_ldim;
 			return Sequence<T>(m_data + start, m_data + start + m_nrows);
 		}
 
 		Sequence<T> diagonal() const {
-			int n = std::min(m_nrows, m_ncols), inc = 1 + m_ldim;
+			index_t n = std::min(m_nrows, m_ncols), inc = 1 + m_ldim;
 			return Sequence<T>(m_data, m_data + inc * n, inc);
 		}
 
-		Sequence<T> subDiagonal(int pos) const;
+		Sequence<T> subDiagonal(index_t pos) const;
 
 		SequenceIterator<T> rowsIterator() const {
 			return SequenceIterator<T>(row(-1), m_nrows, 1);
@@ -81,35 +84,35 @@ namespace NUMCPP {
 			return m_ncols == m_nrows;
 		}
 
-		FastMatrix<T> left(int n) const{
+		FastMatrix<T> left(index_t n) const{
 			return FastMatrix(m_data, m_ldim, m_nrows, n);
 		}
 
-		FastMatrix<T> right(int n) const {
-			int nc = m_ncols - n;
+		FastMatrix<T> right(index_t n) const {
+			index_t nc = m_ncols - n;
 			return FastMatrix(m_data+m_ldim*nc, m_ldim, m_nrows, n);
 		}
 
-		FastMatrix<T> top(int n) const{
+		FastMatrix<T> top(index_t n) const{
 			return FastMatrix(m_data, m_ldim, n, m_ncols);
 		}
 
-		FastMatrix<T> bottom(int n) const{
-			int nr = m_nrows - n;
+		FastMatrix<T> bottom(index_t n) const{
+			index_t nr = m_nrows - n;
 			return FastMatrix(m_data+nr, m_ldim, n, m_ncols);
 		}
 
-		FastMatrix<T> topLeft(int m, int n) const {
+		FastMatrix<T> topLeft(index_t m, index_t n) const {
 			return FastMatrix(m_data, m_ldim, m, n);
 		}
 
-		FastMatrix<T> bottomRight(int m, int n) const {
-			int nc = m_ncols - n;
-			int nr = m_nrows - n;
+		FastMatrix<T> bottomRight(index_t m, index_t n) const {
+			index_t nc = m_ncols - n;
+			index_t nr = m_nrows - n;
 			return FastMatrix(m_data + m_ldim * nc+nr, m_ldim, m, n);
 		}
 
-		FastMatrix<T> extract(int r0, int nr, int c0, int nc)const {
+		FastMatrix<T> extract(index_t r0, index_t nr, index_t c0, index_t nc)const {
 			return FastMatrix(m_data + m_ldim * c0+r0, m_ldim, nr, nc);
 		}
 
@@ -130,20 +133,20 @@ namespace NUMCPP {
 			return *this;
 		}
 
-		FastMatrix& next(int nr, int nc) {
+		FastMatrix& next(index_t nr, index_t nc) {
 			m_data += m_ncols * m_ldim+m_nrows;
 			m_nrows = nr;
 			m_ncols = nc;
 			return *this;
 		}
 
-		FastMatrix& hnext(int nc) {
+		FastMatrix& hnext(index_t nc) {
 			m_data += m_ncols * m_ldim;
 			m_ncols = nc;
 			return *this;
 		}
 
-		FastMatrix& vnext(int nr) {
+		FastMatrix& vnext(index_t nr) {
 			m_data += m_nrows;
 			m_nrows = nr;
 			return *this;
@@ -157,24 +160,28 @@ namespace NUMCPP {
 			mul(m_data, m_ldim, m_nrows, m_ncols, value);
 		}
 
-		static void set(T* C, int ldc, int m, int n, T value);
+		static void set(T* C, index_t ldc, index_t m, index_t n, T value);
 
-		static void mul(T* C, int ldc, int m, int n, T beta);
+		static void mul(T* C, index_t ldc, index_t m, index_t n, T beta);
 
 
 		template<typename S>
 		friend std::ostream& operator<< (std::ostream& stream, const FastMatrix<S>& matrix);
 
+		template<typename S>
+		friend Matrix<S> transpose(const FastMatrix<S>& M);
+
 	private:
 
-		FastMatrix(T* data, int lda, int nrows, int ncols) :
+		FastMatrix(T* data, index_t lda, index_t nrows, index_t ncols) :
 			m_data(data), m_ldim(lda), m_nrows(nrows), m_ncols(ncols)
 		{ }
 
 		T* m_data;
-		int  m_ldim, m_nrows, m_ncols;
+		index_t  m_ldim, m_nrows, m_ncols;
 
 		friend Matrix<T>;
+		friend SharedMatrix<T>;
 	};
 
 	template<typename T>
@@ -183,10 +190,10 @@ namespace NUMCPP {
 	public:
 
 		Matrix();
-		Matrix(int nrows, int ncols);
+		Matrix(index_t nrows, index_t ncols);
 
 		template<class Fn>
-		Matrix(int nrows, int ncols, Fn fn);
+		Matrix(index_t nrows, index_t ncols, Fn fn);
 
 		Matrix(const Matrix<T>& matrix);
 
@@ -197,17 +204,17 @@ namespace NUMCPP {
 
 		FastMatrix<T> all()const;
 
-		FastMatrix<T> extract(int r0, int nr, int c0, int nc)const;
+		FastMatrix<T> extract(index_t r0, index_t nr, index_t c0, index_t nc)const;
 
-		int getNrows()const {
+		index_t getNrows()const {
 			return m_nrows;
 		}
 
-		int getNcols()const {
+		index_t getNcols()const {
 			return m_ncols;
 		}
 
-		T& operator()(int r, int c) const{
+		T& operator()(index_t r, index_t c) const{
 			return m_data[r + m_nrows * c];
 		}
 
@@ -220,16 +227,27 @@ namespace NUMCPP {
 
 		void rand()const;
 
+		/// <summary>
+		/// Uniform ]0, 1[ fill in column-major order; item (r, c) receives
+		/// the output offset + r + c * nrows of rng
+		/// </summary>
+		void rand(const Philox& rng, uint64_t offset = 0)const;
+
+		/// <summary>
+		/// Standard normal fill in column-major order
+		/// </summary>
+		void randn(const Philox& rng, uint64_t offset = 0)const;
+
 		Matrix<T>& operator=(T x);
 
-		int size()const;
+		index_t size()const;
 
-		Sequence<T> row(int row)const {
+		Sequence<T> row(index_t row)const {
 			return Sequence<T>(m_data + row, m_data + row + m_nrows * m_ncols, m_nrows);
 		}
 
-		Sequence<T> column(int col)const {
-			int start = col * m_nrows;
+		Sequence<T> column(index_t col)const {
+			index_t start = col * m_nrows;
 			return Sequence<T>(m_data + start, m_data + start + m_nrows);
 		}
 
@@ -241,12 +259,12 @@ namespace NUMCPP {
 
 	private:
 
-		T* pos(int r, int c)const {
+		T* pos(index_t r, index_t c)const {
 			return m_data + r + c * m_nrows;
 		}
 
 		T* m_data;
-		int m_nrows, m_ncols;
+		index_t m_nrows, m_ncols;
 
 	};
 
@@ -263,20 +281,20 @@ namespace NUMCPP {
 	}
 
 	template<typename T>
-	inline FastMatrix<T> Matrix<T>::extract(int r0, int nr, int c0, int nc) const {
+	inline FastMatrix<T> Matrix<T>::extract(index_t r0, index_t nr, index_t c0, index_t nc) const {
 		return FastMatrix<T>(pos(r0, c0), m_nrows, nr, nc);
 	}
 
 	template<typename T>
-	Sequence<T> FastMatrix<T>::subDiagonal(int pos) const {
+	Sequence<T> FastMatrix<T>::subDiagonal(index_t pos) const {
 		if (pos >= m_ncols) {
 			return Sequence<T>();
 		}
 		if (-pos >= m_nrows) {
 			return Sequence<T>();
 		}
-		int beg = 0, inc = 1 + m_ldim;
-		int n;
+		index_t beg = 0, inc = 1 + m_ldim;
+		index_t n;
 		if (pos > 0) {
 			beg += pos * m_ldim;
 			n =std::min(m_nrows, m_ncols - pos);
@@ -292,23 +310,23 @@ namespace NUMCPP {
 	}
 
 	template<typename T>
-	inline int Matrix<T>::size()const {
+	inline index_t Matrix<T>::size()const {
 		return m_nrows * m_ncols;
 	}
 
 	template<typename T>
-	Matrix<T>::Matrix(int nrows, int ncols)
+	Matrix<T>::Matrix(index_t nrows, index_t ncols)
 		:m_data(new T[nrows * ncols]), m_nrows(nrows), m_ncols(ncols)
 	{
 	}
 
 	template<typename T>
 	template<class Fn>
-	Matrix<T>::Matrix(int nrows, int ncols, Fn op) 
+	Matrix<T>::Matrix(index_t nrows, index_t ncols, Fn op) 
 		: m_data(new T[nrows * ncols]), m_nrows(nrows), m_ncols(ncols)
 	{
-		for (int c = 0, j = 0; c < ncols; ++c) {
-			for (int r=0; r<nrows; ++r, ++j)
+		for (index_t c = 0, j = 0; c < ncols; ++c) {
+			for (index_t r=0; r<nrows; ++r, ++j)
 				m_data[j]=op(r,c);
 		}
 	}
@@ -316,9 +334,9 @@ namespace NUMCPP {
 	template<typename T>
 	Matrix<T>::Matrix(const Matrix<T>& matrix)
 	{
-		int size = matrix.m_nrows * matrix.m_ncols;
+		index_t size = matrix.m_nrows * matrix.m_ncols;
 		m_data = new T[size];
-		for (int i = 0; i < size; ++i) {
+		for (index_t i = 0; i < size; ++i) {
 			m_data[i] = matrix.m_data[i];
 		}
 		m_nrows = matrix.m_nrows;
@@ -330,11 +348,11 @@ namespace NUMCPP {
 	Matrix<T>& Matrix<T>::operator=(const Matrix<T>& matrix)
 	{
 		if (this != &matrix) {
-			int size = matrix.m_nrows * matrix.m_ncols;
+			index_t size = matrix.m_nrows * matrix.m_ncols;
 			if (nullptr != m_data)
 				delete[] m_data;
 			m_data = new T[size];
-			for (int i = 0; i < size; ++i) {
+			for (index_t i = 0; i < size; ++i) {
 				m_data[i] = matrix.m_data[i];
 			}
 			m_nrows = matrix.m_nrows;
@@ -351,19 +369,28 @@ namespace NUMCPP {
 
 	template<>
 	inline void Matrix<double>::rand()const {
-		std::random_device rd;
-		std::mt19937 mt(rd());
-		std::uniform_real_distribution<double> dist(1.0, 10.0);
-		int sz = size();
-		for (int u = 0; u < sz; ++u)
-			m_data[u] = dist(mt);
+		// uniform in [1, 10[
+		index_t sz = size();
+		Philox::fromEntropy().uniform(0, sz, m_data, 1);
+		for (index_t u = 0; u < sz; ++u)
+			m_data[u] = 1 + 9 * m_data[u];
+	}
+
+	template<>
+	inline void Matrix<double>::rand(const Philox& rng, uint64_t offset)const {
+		rng.uniform(offset, size(), m_data, 1);
+	}
+
+	template<>
+	inline void Matrix<double>::randn(const Philox& rng, uint64_t offset)const {
+		rng.normal(offset, size(), m_data, 1);
 	}
 
 	template<typename T>
 	Matrix<T>& Matrix<T>::operator=(T x)
 	{
-		int sz = size();
-		for (int u = 0; u < sz; ++u)
+		index_t sz = size();
+		for (index_t u = 0; u < sz; ++u)
 			m_data[u] = x;
 		return *this;
 	}
@@ -371,14 +398,9 @@ namespace NUMCPP {
 	template<typename T>
 	Matrix<T> transpose(const FastMatrix<T>& M)
 	{
-		int nr = M.getNrows(), nc = M.getNcols();
+		index_t nr = M.getNrows(), nc = M.getNcols();
 		Matrix<T> R(nc, nr);
-		NUMCPP::SequenceIterator<T> rows = M.rowsIterator();
-		T* ptr = R.m_data;
-		while (rows.hasNext()) {
-			rows.next().copyTo(ptr);
-			ptr += nc;
-		}
+		Copies<T>::transpose(nr, nc, M.m_data, M.m_ldim, R.m_data, nc);
 		return R;
 	}
 
@@ -391,9 +413,9 @@ namespace NUMCPP {
 	template<typename T>
 	std::ostream& operator<< (std::ostream& stream, const FastMatrix<T>& matrix) {
 		if (!matrix.isEmpty())
-			for (int i = 0; i < matrix.m_nrows; ++i) {
+			for (index_t i = 0; i < matrix.m_nrows; ++i) {
 				stream << matrix(i, 0);
-				for (int j = 1; j < matrix.m_ncols; ++j)
+				for (index_t j = 1; j < matrix.m_ncols; ++j)
 					stream << '\t' << matrix(i, j);
 				stream << "\n\r";
 			}
@@ -401,7 +423,7 @@ namespace NUMCPP {
 	}
 
 	template<typename T>
-	void FastMatrix<T>::set(T* C, int ldc, int m, int n, T value) {
+	void FastMatrix<T>::set(T* C, index_t ldc, index_t m, index_t n, T value) {
 		T* cstart = C;
 		T* const end = C + ldc * n;
 		while (cstart != end) {
@@ -418,16 +440,16 @@ namespace NUMCPP {
 	void FastMatrix<T>::set(Fn fn)const
 	{
 		T* data = m_data;
-		for (int c = 0; c < m_ncols; ++c) {
+		for (index_t c = 0; c < m_ncols; ++c) {
 			T* datac = data;
-			for (int r = 0; r < m_nrows; ++r)
+			for (index_t r = 0; r < m_nrows; ++r)
 				*datac++ = fn(r, c);
 			data += m_ldim;
 		}
 	}
 
 	template<typename T>
-	void FastMatrix<T>::mul(T* C, int ldc, int m, int n, T value) {
+	void FastMatrix<T>::mul(T* C, index_t ldc, index_t m, index_t n, T value) {
 		if (value == NUMCPP::CONSTANTS<T>::one)
 			return;
 		if (value == NUMCPP::CONSTANTS<T>::zero) {
@@ -3,9 +3,12 @@
 
 #include <exception>
 #include <iostream>
+#include "config.h"
 
 namespace LCPP {
 
+	using NUMCPP::index_t;
+
 	enum Triangular {
 		Lower, Upper
 	};
@@ -37,7 +40,7 @@ namespace LCPP {
 
 		LASWP() {}
 
-		void operator()(int n, T* A, int lda, int k1, int k2, int* piv, int incx);
+		void operator()(index_t n, T* A, index_t lda, index_t k1, index_t k2, index_t* piv, index_t incx);
 
 	private:
 
@@ -45,8 +48,8 @@ namespace LCPP {
 	};
 
 	template<typename T>
-	void LASWP<T>::operator()(int n, T* A, int lda, int k1, int k2, int* piv, int incx) {
-		int ix0, i1, i2, inc;
+	void LASWP<T>::operator()(index_t n, T* A, index_t lda, index_t k1, index_t k2, index_t* piv, index_t incx) {
+		index_t ix0, i1, i2, inc;
 		if (incx > 0) {
 			ix0 = k1;
 			i1 = k1;
@@ -62,15 +65,15 @@ namespace LCPP {
 		else {
 			return;
 		}
-		int nb = (n / BLOCK) * BLOCK;
+		index_t nb = (n / BLOCK) * BLOCK;
 		T* C = A;
 		if (nb != 0){
-			for (int j = 0; j < nb; j += BLOCK, C+=lda) {
-				for (int i = i1, ix = ix0; i < i2; i += inc, ix += incx) {
-					int ip = piv[ix];
+			for (index_t j = 0; j < nb; j += BLOCK, C+=lda) {
+				for (index_t i = i1, ix = ix0; i < i2; i += inc, ix += incx) {
+					index_t ip = piv[ix];
 					if (ip != i) {
 						T* ci = C + i, * cip = C + ip;
-						for (int k = j; k < j+BLOCK; ++k, ci += lda, cip += lda) {
+						for (index_t k = j; k < j+BLOCK; ++k, ci += lda, cip += lda) {
 							T tmp = *ci;
 							*ci = *cip;
 							*cip = tmp;
@@ -80,11 +83,11 @@ namespace LCPP {
 			}
 		}
 		if (nb < n) {
-			for (int i = i1, ix = ix0; i < i2; i += inc, ix += incx) {
-				int ip = piv[ix];
+			for (index_t i = i1, ix = ix0; i < i2; i += inc, ix += incx) {
+				index_t ip = piv[ix];
 				if (ip != i) {
 					T* ci = C + i, * cip = C + ip;
-					for (int k = nb; k < n; ++k, ci += lda, cip += lda) {
+					for (index_t k = nb; k < n; ++k, ci += lda, cip += lda) {
 						T tmp = *ci;
 						*ci = *cip;
 						*cip = tmp;
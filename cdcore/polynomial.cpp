@@ -1,255 +1,746 @@
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
 
 #include "polynomials.h"
+#include "convolution.h"
+#include "fft.h"
+#include "rationalexpansion.h"
+#include "polynomialroots.h"
 
 using namespace NUMCPP;
 
+namespace {
+
+	const double TWOPI = 6.283185307179586476925286766559;
+
+	// Cost of a real FFT of size N, in units of N log2(N) coefficients of a direct evaluation
+	// (one multiply-add per coefficient with the table of roots of unity). Measured between
+	// 0.5 and 0.7 on x86-64 (g++ -O2, N from 64 to 65536, 8 to 512 coefficients); the exact
+	// value only moves the switch point by a small factor and may be tuned for other targets
+	const double GRID_FFT_COST = 0.6;
+	// Largest tables of roots of unity and FFT used by the grid evaluations
+	const int GRID_TABLE_MAX = 1 << 16, GRID_FFT_MAX = 1 << 22;
+	// exp(i w) is recomputed every GRID_RESYNC points of the rotation recurrence
+	const int GRID_RESYNC = 64;
+
+	// c[0] + c[1] z + ... + c[n-1] z^(n-1), n > 0
+	inline std::complex<double> horner(const double* c, int n, double zr, double zi) {
+		double fr = c[n - 1], fi = 0;
+		for (int i = n - 2; i >= 0; --i) {
+			double tr = fr * zr - fi * zi + c[i];
+			fi = fr * zi + fi * zr;
+			fr = tr;
+		}
+		return std::complex<double>(fr, fi);
+	}
+
+	// Checks that w0 + k dw = 2 pi (m0 + k) / N for integers N > 0 and m0 in [0, N[
+	bool fourierGrid(double w0, double dw, int& N, int& m0) {
+		if (!(dw > 0))
+			return false;
+		double r = TWOPI / dw, rn = std::round(r);
+		if (rn < 1 || rn > GRID_FFT_MAX || std::abs(r - rn) > 1e-9 * rn)
+			return false;
+		double m = w0 / dw, rm = std::round(m);
+		if (std::abs(m - rm) > 1e-9 * std::max(1.0, std::abs(m)))
+			return false;
+		N = (int)rn;
+		m0 = (int)std::fmod(rm, rn);
+		if (m0 < 0)
+			m0 += N;
+		return true;
+	}
+
+	// store(k, P(exp(i (w0 + k dw)))), k in [0, n[
+	template <class S>
+	void frequencyGrid(const double* c, int nc, double w0, double dw, int n, S store) {
+		int N, m0;
+		if (fourierGrid(w0, dw, N, m0)) {
+			double direct = double(n) * nc;
+			if (N >= 2 && N == FFT::powerOf2(N) && GRID_FFT_COST * N * std::log2(double(N)) + nc < direct) {
+				// P(exp(2 i pi k/N)) = conj(X[k]), with X the transform of the folded coefficients
+				std::vector<double> x(N, 0.0);
+				for (int j = 0; j < nc; ++j)
+					x[j % N] += c[j];
+				std::vector<std::complex<double>> X(N / 2 + 1);
+				RealFFT::plan(N).forward(x.data(), X.data());
+				for (int k = 0, idx = m0; k < n; ++k) {
+					store(k, idx <= N / 2 ? std::conj(X[idx]) : X[N - idx]);
+					if (++idx == N)
+						idx = 0;
+				}
+				return;
+			}
+			if (N <= GRID_TABLE_MAX) {
+				// exp(i w j) = conj(t[(m0 + k) j mod N])
+				const std::complex<double>* t = FFT::twiddles(N).data();
+				for (int k = 0, step = m0; k < n; ++k) {
+					double re = 0, im = 0;
+					for (int j = 0, idx = 0; j < nc; ++j) {
+						re += c[j] * t[idx].real();
+						im -= c[j] * t[idx].imag();
+						idx += step;
+						if (idx >= N)
+							idx -= N;
+					}
+					store(k, std::complex<double>(re, im));
+					if (++step == N)
+						step = 0;
+				}
+				return;
+			}
+		}
+		std::complex<double> r = std::polar(1.0, dw), z;
+		for (int k = 0; k < n; ++k) {
+			if (k % GRID_RESYNC == 0)
+				z = std::polar(1.0, w0 + k * dw);
+			else
+				z = std::complex<double>(z.real() * r.real() - z.imag() * r.imag(), z.real() * r.imag() + z.imag() * r.real());
+			store(k, horner(c, nc, z.real(), z.imag()));
+		}
+	}
+}
+
 Polynomial::~Polynomial() {
+	release();
+}
+
+namespace {
+
+	// Header of the heap blocks of coefficients, shared by the copies of a polynomial
+	struct alignas(NUMCPP_ALIGNMENT) SharedCoefficients {
+		SharedCoefficients() :refs(1) {}
+		AtomicCount refs;
+	};
+
+	inline SharedCoefficients* header(double* p) {
+		return reinterpret_cast<SharedCoefficients*>(p) - 1;
+	}
+}
+
+bool Polynomial::isShared()const {
+	return m_p != m_local && !header(m_p)->refs.unique();
 }
 
-Polynomial::Polynomial(const Polynomial& p) {
-	m_c = p.m_c;
+void Polynomial::release() {
+	if (m_p != m_local) {
+		SharedCoefficients* h = header(m_p);
+		if (h->refs.decrement() == 0) {
+			h->~SharedCoefficients();
+			_vectorallocator::free(h);
+		}
+	}
+	m_p = m_local;
+	m_cap = INLINE_DEGREE + 1;
+}
+
+void Polynomial::assign(const double* c, int n) {
+	m_n = 0;
+	double* p = reserve(n);
+	std::copy(c, c + n, p);
+	m_n = n;
+}
+
+void Polynomial::share(const Polynomial& p) {
+	header(p.m_p)->refs.increment();
+	release();
+	m_p = p.m_p;
+	m_n = p.m_n;
+	m_cap = p.m_cap;
+}
+
+Polynomial::Polynomial(const Polynomial& p) :Polynomial() {
+	if (p.m_p != p.m_local)
+		share(p);
+	else
+		assign(p.m_p, p.m_n);
+}
+
+Polynomial::Polynomial(Polynomial&& p) noexcept :Polynomial() {
+	*this = std::move(p);
 }
 
 Polynomial& Polynomial::operator=(const Polynomial& p) {
-	if (&p == this)
+	if (&p == this || (p.m_p == m_p && p.m_p != p.m_local))
 		return *this;
-	m_c = p.m_c;
+	if (p.m_p != p.m_local)
+		share(p);
+	else
+		assign(p.m_p, p.m_n);
 	return *this;
 }
 
-Polynomial::Polynomial(int degree, double val) {
-	double* c = new double[degree + 1];
-	for (int i = 0; i <= degree; ++i) {
-		c[i] = val;
+Polynomial& Polynomial::operator=(Polynomial&& p) noexcept {
+	if (&p == this)
+		return *this;
+	if (p.m_p == p.m_local) {
+		if (isShared())
+			release();
+		std::copy(p.m_local, p.m_local + p.m_n, m_p);
+	}
+	else {
+		// takes the heap block of p
+		release();
+		m_p = p.m_p;
+		m_cap = p.m_cap;
+		p.m_p = p.m_local;
+		p.m_cap = INLINE_DEGREE + 1;
 	}
-	m_c = _cvector<double>(c, degree + 1);
+	m_n = p.m_n;
+	p.m_n = 0;
+	return *this;
+}
+
+Polynomial::Polynomial(int degree, double val) :Polynomial() {
+	int n = degree + 1;
+	double* p = reserve(n);
+	for (int i = 0; i < n; ++i)
+		p[i] = val;
+	m_n = n;
+}
+
+Polynomial::Polynomial(int degree, const double* val) :Polynomial() {
+	assign(val, degree + 1);
+}
+
+double* Polynomial::reserve(int n) {
+	bool shared = isShared();
+	if (n <= m_cap && !shared)
+		return m_p;
+	// geometric growth; a shared block is copied before any modification
+	int ncap = n <= m_cap ? m_cap : std::max(n, 2 * m_cap);
+	void* block = _vectorallocator::alloc(sizeof(SharedCoefficients) + ncap * sizeof(double), NUMCPP_ALIGNMENT);
+	double* p = reinterpret_cast<double*>(new (block) SharedCoefficients() + 1);
+	std::copy(m_p, m_p + m_n, p);
+	release();
+	m_p = p;
+	m_cap = ncap;
+	return p;
+}
+
+int Polynomial::addInto(double* out, const Polynomial& a, const Polynomial& b) {
+	if (!a.isValid() || !b.isValid())
+		return 0;
+	const double* pa = a.coefficients(), * pb = b.coefficients();
+	int na = a.m_n, nb = b.m_n;
+	int nmin = std::min(na, nb);
+	for (int i = 0; i < nmin; ++i)
+		out[i] = pa[i] + pb[i];
+	for (int i = nmin; i < na; ++i)
+		out[i] = pa[i];
+	for (int i = nmin; i < nb; ++i)
+		out[i] = pb[i];
+	return std::max(na, nb);
 }
 
-Polynomial::Polynomial(int degree, double* val) {
-	double* c = new double[degree + 1];
-	for (int i = 0; i <= degree; ++i) {
-		c[i] = val[i];
+int Polynomial::subtractInto(double* out, const Polynomial& a, const Polynomial& b) {
+	if (!a.isValid() || !b.isValid())
+		return 0;
+	const double* pa = a.coefficients(), * pb = b.coefficients();
+	int na = a.m_n, nb = b.m_n;
+	int nmin = std::min(na, nb);
+	for (int i = 0; i < nmin; ++i)
+		out[i] = pa[i] - pb[i];
+	for (int i = nmin; i < na; ++i)
+		out[i] = pa[i];
+	for (int i = nmin; i < nb; ++i)
+		out[i] = -pb[i];
+	return std::max(na, nb);
+}
+
+int Polynomial::multiplyInto(double* out, const Polynomial& a, const Polynomial& b) {
+	if (!a.isValid() || !b.isValid())
+		return 0;
+	const double* pa = a.coefficients(), * pb = b.coefficients();
+	int na = a.m_n, nb = b.m_n;
+	int n = na + nb - 1;
+	if (Convolution::select(na, nb) != Convolution::Schoolbook) {
+		Convolution::multiply(pa, na, pb, nb, out);
+		return n;
+	}
+	for (int i = 0; i < n; ++i)
+		out[i] = 0;
+	for (int i = 0; i < na; ++i) {
+		double ai = pa[i];
+		if (ai != 0) {
+			double* o = out + i;
+			for (int j = 0; j < nb; ++j) {
+				if (pb[j] != 0)
+					o[j] += ai * pb[j];
+			}
+		}
 	}
-	m_c = _cvector<double>(c, degree + 1);
+	return n;
 }
 
-Polynomial Polynomial::operator+(const Polynomial& r)const {
-	if (!m_c.isValid() || !r.m_c.isValid())
-		return Polynomial();
-	int ld = getDegree(), rd=r.getDegree();
-	// swap l and r if l.Degree < r.Degree
-	if (ld < rd) {
-		return r + (*this);
+void Polynomial::divide(const Polynomial& a, const Polynomial& b, Polynomial& q, Polynomial& r) {
+	if (&q == &a || &q == &b || &r == &b || &q == &r) {
+		Polynomial tq, tr;
+		divide(a, b, tq, tr);
+		q = std::move(tq);
+		r = std::move(tr);
+		return;
+	}
+	int nb = b.m_n;
+	while (nb > 0 && b.m_p[nb - 1] == 0)
+		--nb;
+	if (!a.isValid() || nb == 0) {
+		q = Polynomial();
+		r = Polynomial();
+		return;
+	}
+	if (&r != &a)
+		r.assign(a.m_p, a.m_n);
+	int na = r.m_n;
+	if (na < nb) {
+		q = ZERO;
+		return;
 	}
-	double* result = new double[ld+1];
-	for (int i = 0; i <= rd; ++i) {
-		result[i] = m_c[i]+r.m_c[i];
+	const double* pb = b.m_p;
+	double lead = pb[nb - 1];
+	int nq = na - nb + 1;
+	q.m_n = 0;
+	double* pq = q.reserve(nq);
+	double* pr = r.reserve(na);
+	for (int k = nq - 1; k >= 0; --k) {
+		double c = pr[k + nb - 1] / lead;
+		pq[k] = c;
+		if (c != 0) {
+			double* o = pr + k;
+			for (int j = 0; j < nb - 1; ++j)
+				o[j] -= c * pb[j];
+		}
+	}
+	q.m_n = nq;
+	if (nb == 1) {
+		pr[0] = 0;
+		r.m_n = 1;
 	}
-	for (int i = rd + 1; i <= ld; ++i) {
-		result[i] = m_c[i];
+	else {
+		r.m_n = nb - 1;
 	}
-	return Polynomial(ld, result);
 }
 
-Polynomial Polynomial::operator-(const Polynomial& r)const {
-	if (!m_c.isValid() || !r.m_c.isValid())
-		return Polynomial();
-	int ld = getDegree(), rd = r.getDegree();
-	if (ld >= rd) {
-		double* result = new double[ld + 1];
-		for (int i = 0; i <= rd; ++i) {
-			result[i] = m_c[i] - r.m_c[i];
+Polynomial Polynomial::operator/(const Polynomial& b)const {
+	Polynomial q, r;
+	divide(*this, b, q, r);
+	return q;
+}
+
+Polynomial Polynomial::operator%(const Polynomial& b)const {
+	Polynomial q, r;
+	divide(*this, b, q, r);
+	return r;
+}
+
+namespace {
+
+	// Inline size of the scratch arrays of approximateGcd: no heap allocation for
+	// the polynomials stored inline
+	const int GCD_SCRATCH = Polynomial::INLINE_DEGREE + 1;
+
+	// Marks the structure of the roots r[0, n[ of a real polynomial in pair[0, n[:
+	// -1 for a real root (its imaginary part below tolerance * max(1, |z|) is set to 0),
+	// j for a root of positive imaginary part whose conjugate is r[j],
+	// -2 (-3 once taken as a conjugate) for the other roots (of negative imaginary part,
+	// unpaired or infinite)
+	void conjugatePairs(std::complex<double>* r, int n, double tolerance, int* pair) {
+		for (int i = 0; i < n; ++i) {
+			pair[i] = -2;
+			if (std::isfinite(r[i].real()) && std::isfinite(r[i].imag())
+				&& std::abs(r[i].imag()) <= tolerance * std::max(1.0, std::abs(r[i]))) {
+				r[i] = r[i].real();
+				pair[i] = -1;
+			}
 		}
-		for (int i = rd + 1; i <= ld; ++i) {
-			result[i] = m_c[i];
+		for (int i = 0; i < n; ++i) {
+			if (!(r[i].imag() > 0) || !std::isfinite(r[i].real()) || !std::isfinite(r[i].imag()))
+				continue;
+			std::complex<double> zc = std::conj(r[i]);
+			int jmin = -1;
+			double dmin = tolerance * std::max(1.0, std::abs(zc));
+			for (int j = 0; j < n; ++j) {
+				double dist = std::abs(r[j] - zc);
+				if (pair[j] == -2 && r[j].imag() < 0 && dist <= dmin) {
+					dmin = dist;
+					jmin = j;
+				}
+			}
+			if (jmin >= 0) {
+				pair[jmin] = -3;
+				pair[i] = jmin;
+			}
 		}
-		return Polynomial(ld, result);
 	}
-	else {
-		double* result = new double[rd + 1];
-		for (int i = 0; i <= ld; ++i) {
-			result[i] = m_c[i] - r.m_c[i];
-		}
-		for (int i = ld + 1; i <= rd; ++i) {
-			result[i] = -r.m_c[i];
+
+	// Nearest root rb[j] of z (within tolerance * max(1, |z|)) with the same structure
+	// (real or first root of a pair) that has not been used; -1 if none
+	int nearestRoot(const std::complex<double>& z, bool real, const std::complex<double>* rb,
+		const int* pb, const char* used, int nb, double tolerance) {
+		int jmin = -1;
+		double dmin = tolerance * std::max(1.0, std::abs(z));
+		for (int j = 0; j < nb; ++j) {
+			if (used[j] || (real ? pb[j] != -1 : pb[j] < 0))
+				continue;
+			double dist = std::abs(z - rb[j]);
+			if (dist <= dmin) {
+				dmin = dist;
+				jmin = j;
+			}
 		}
-		return Polynomial(rd, result);
+		return jmin;
+	}
 
+	// g[0, n+1[ <- (1 - x/c) g[0, n[, or x g if c = 0. Returns n+1
+	int mulRoot(std::complex<double>* g, int n, const std::complex<double>& c) {
+		g[n] = 0.0;
+		if (c == 0.0) {
+			for (int k = n; k > 0; --k)
+				g[k] = g[k - 1];
+			g[0] = 0;
+		}
+		else {
+			std::complex<double> f = -1.0 / c;
+			for (int k = n; k > 0; --k)
+				g[k] += f * g[k - 1];
+		}
+		return n + 1;
 	}
 }
 
-Polynomial Polynomial::operator*(const Polynomial& r)const {
-	if (! m_c.isValid() || !r.m_c.isValid())
-		return Polynomial();
-	int ldeg = getDegree(), rdeg = r.getDegree();
-	if (ldeg==0)
-		return r * m_c[0];
-	if (rdeg ==0)
-		return (*this) * r.m_c[0];
-	int n = ldeg+rdeg;
-	double* result = new double[n + 1];
-	for (int i = 0; i <= n; ++i)
-		result[i] = 0;
-	for (int i = 0; i <= ldeg; ++i) {
-		if (m_c[i] != 0) {
-			for (int j = 0; j <= rdeg; ++j) {
-				if (r.m_c[j] != 0) {
-					result[i+j] += m_c[i] * r.m_c[j];
-				}
-			}
+Polynomial Polynomial::approximateGcd(const Polynomial& a, const Polynomial& b, double tolerance) {
+	int da = a.getDegree(), db = b.getDegree();
+	if (da <= 0 || db <= 0)
+		return ONE;
+	SmallBlock<std::complex<double>, GCD_SCRATCH> ra(da), rb(db);
+	int na = PolynomialRoots::roots(a, ra.data()), nb = PolynomialRoots::roots(b, rb.data());
+	if (na <= 0 || nb <= 0)
+		return ONE;
+	SmallBlock<int, GCD_SCRATCH> pa(na), pb(nb);
+	conjugatePairs(ra.data(), na, tolerance, pa.data());
+	conjugatePairs(rb.data(), nb, tolerance, pb.data());
+	// g = prod (1 - x/z); the complex common roots are taken by conjugate pairs
+	// (a pair of a matches a pair of b), so that g is real up to rounding errors
+	SmallBlock<std::complex<double>, GCD_SCRATCH> g(std::min(na, nb) + 1);
+	SmallBlock<char, GCD_SCRATCH> used(nb, 0);
+	g(0) = 1.0;
+	int ng = 1;
+	for (int i = 0; i < na; ++i) {
+		if (pa(i) < -1)
+			continue;
+		bool real = pa(i) == -1;
+		int j = nearestRoot(ra(i), real, rb.data(), pb.data(), used.data(), nb, tolerance);
+		if (j < 0)
+			continue;
+		used(j) = 1;
+		if (real) {
+			ng = mulRoot(g.data(), ng, 0.5 * (ra(i).real() + rb(j).real()));
 		}
+		else {
+			used(pb(j)) = 1;
+			std::complex<double> c = 0.25 * (ra(i) + std::conj(ra(pa(i))) + rb(j) + std::conj(rb(pb(j))));
+			ng = mulRoot(g.data(), ng, c);
+			ng = mulRoot(g.data(), ng, std::conj(c));
+		}
+	}
+	int dg = ng - 1;
+	if (dg == 0)
+		return ONE;
+	double gmax = 0, imax = 0;
+	for (int k = 0; k <= dg; ++k) {
+		gmax = std::max(gmax, std::abs(g(k).real()));
+		imax = std::max(imax, std::abs(g(k).imag()));
 	}
-	return Polynomial(n, result);
+	// safeguard: g must be real up to the rounding errors of the products
+	if (!(imax <= 64 * std::numeric_limits<double>::epsilon() * (dg + 1) * gmax))
+		return ONE;
+	Polynomial result;
+	double* p = result.reserve(dg + 1);
+	for (int k = 0; k <= dg; ++k)
+		p[k] = g(k).real();
+	result.m_n = dg + 1;
+	return result;
+}
 
+Polynomial Polynomial::operator+(const Polynomial& r)const {
+	if (!isValid() || !r.isValid())
+		return Polynomial();
+	Polynomial result;
+	result.m_n = addInto(result.reserve(std::max(m_n, r.m_n)), *this, r);
+	return result;
+}
+
+Polynomial Polynomial::operator-(const Polynomial& r)const {
+	if (!isValid() || !r.isValid())
+		return Polynomial();
+	Polynomial result;
+	result.m_n = subtractInto(result.reserve(std::max(m_n, r.m_n)), *this, r);
+	return result;
+}
+
+Polynomial Polynomial::operator*(const Polynomial& r)const {
+	if (!isValid() || !r.isValid())
+		return Polynomial();
+	if (m_n == 1)
+		return r * coefficients()[0];
+	if (r.m_n == 1)
+		return (*this) * r.coefficients()[0];
+	Polynomial result;
+	result.m_n = multiplyInto(result.reserve(m_n + r.m_n - 1), *this, r);
+	return result;
 }
 
 Polynomial Polynomial::operator*(double a)const {
-	if (! m_c.isValid())
+	if (!isValid())
 		return Polynomial();
 	if (a == 0)
 		return Polynomial::ZERO;
-	if (a == 1)
-		return *this;
-	int n = m_c.length();
-	double* result = new double[n];
-	for (int i = 0; i < n; ++i) {
-		result[i] = m_c[i] * a;
-	}
-	return Polynomial(n-1, result);
+	Polynomial result(*this);
+	return result *= a;
 }
 
 Polynomial Polynomial::operator+(double a)const {
-	if (!m_c.isValid())
-		return Polynomial();
-	if (a == 0)
-		return *this;
-	int n = m_c.length();
-	double* result = new double[n];
-	for (int i = 0; i < n; ++i) {
-		result[i] = m_c[i] + a;
-	}
-	return Polynomial(n - 1, result);
+	Polynomial result(*this);
+	return result += a;
 }
 
 Polynomial Polynomial::operator-(double a)const {
-	if (!m_c.isValid())
-		return Polynomial();
-	if (a == 0)
-		return *this;
-	int n = m_c.length();
-	double* result = new double[n];
-	for (int i = 0; i < n; ++i) {
-		result[i] = m_c[i] - a;
-	}
-	return Polynomial(n - 1, result);
+	Polynomial result(*this);
+	return result -= a;
 }
 
 Polynomial Polynomial::operator/(double a)const {
-	if (!m_c.isValid())
-		return Polynomial();
-	if (a == 1)
+	Polynomial result(*this);
+	return result /= a;
+}
+
+Polynomial& Polynomial::operator+=(const Polynomial& r) {
+	if (!isValid() || !r.isValid())
+		return *this = Polynomial();
+	int n = std::max(m_n, r.m_n);
+	double* p = reserve(n);
+	// read after reserve: r may be *this
+	const double* pr = r.coefficients();
+	int nr = r.m_n;
+	for (int i = m_n; i < n; ++i)
+		p[i] = 0;
+	for (int i = 0; i < nr; ++i)
+		p[i] += pr[i];
+	m_n = n;
+	return *this;
+}
+
+Polynomial& Polynomial::operator-=(const Polynomial& r) {
+	if (!isValid() || !r.isValid())
+		return *this = Polynomial();
+	int n = std::max(m_n, r.m_n);
+	double* p = reserve(n);
+	const double* pr = r.coefficients();
+	int nr = r.m_n;
+	for (int i = m_n; i < n; ++i)
+		p[i] = 0;
+	for (int i = 0; i < nr; ++i)
+		p[i] -= pr[i];
+	m_n = n;
+	return *this;
+}
+
+Polynomial& Polynomial::operator*=(const Polynomial& r) {
+	if (!isValid() || !r.isValid())
+		return *this = Polynomial();
+	if (&r == this) {
+		Polynomial tmp(r);
+		return *this *= tmp;
+	}
+	int na = m_n, nr = r.m_n;
+	int n = na + nr - 1;
+	if (Convolution::select(na, nr) != Convolution::Schoolbook) {
+		// fast products are not computed in place
+		Polynomial result;
+		result.m_n = multiplyInto(result.reserve(n), *this, r);
+		return *this = std::move(result);
+	}
+	double* p = reserve(n);
+	const double* pr = r.coefficients();
+	for (int i = na; i < n; ++i)
+		p[i] = 0;
+	// p[i] is consumed before any product is accumulated in it
+	for (int i = na - 1; i >= 0; --i) {
+		double ai = p[i];
+		p[i] = 0;
+		if (ai != 0) {
+			double* o = p + i;
+			for (int j = 0; j < nr; ++j) {
+				if (pr[j] != 0)
+					o[j] += ai * pr[j];
+			}
+		}
+	}
+	m_n = n;
+	return *this;
+}
+
+Polynomial& Polynomial::operator+=(double a) {
+	if (!isValid() || a == 0)
+		return *this;
+	double* p = reserve(m_n);
+	for (int i = 0; i < m_n; ++i)
+		p[i] += a;
+	return *this;
+}
+
+Polynomial& Polynomial::operator-=(double a) {
+	if (!isValid() || a == 0)
+		return *this;
+	double* p = reserve(m_n);
+	for (int i = 0; i < m_n; ++i)
+		p[i] -= a;
+	return *this;
+}
+
+Polynomial& Polynomial::operator*=(double a) {
+	if (!isValid() || a == 1)
+		return *this;
+	if (a == 0) {
+		reserve(1)[0] = 0;
+		m_n = 1;
 		return *this;
-	int n = m_c.length();
-	double* result = new double[n];
-	for (int i = 0; i < n; ++i) {
-		result[i] = m_c[i] / a;
 	}
-	return Polynomial(n - 1, result);
+	double* p = reserve(m_n);
+	for (int i = 0; i < m_n; ++i)
+		p[i] *= a;
+	return *this;
+}
+
+Polynomial& Polynomial::operator/=(double a) {
+	if (!isValid() || a == 1)
+		return *this;
+	double* p = reserve(m_n);
+	for (int i = 0; i < m_n; ++i)
+		p[i] /= a;
+	return *this;
 }
 
 double Polynomial::evaluateAt(double x)const {
 	int i = getDegree();
-	double f = m_c[i--];
+	double f = m_p[i--];
 	for (; i >= 0; --i) {
-		f = m_c[i] + (f * x);
+		f = m_p[i] + (f * x);
 	}
 	return f;
 }
 
-std::complex<double> Polynomial::evaluateAt(const std::complex<double>&  x)const {
-	int i = getDegree();
-	double xr = x.real(), xi = x.imag();
-	double fr = m_c[i--], fi = 0;
-	for (; i >= 0; --i) {m_c[i];
-	double tr = fr * xr - fi * xi + m_c[i];
-	double ti = fr * xi + fi * xr;
-		fr = tr;
-		fi = ti;
-	}
-	return std::complex(fr, fi);
+std::complex<double> Polynomial::evaluateAt(const std::complex<double>& x)const {
+	return horner(m_p, m_n, x.real(), x.imag());
 }
 
-std::complex<double> Polynomial::evaluateAtFrequency(double w)const {
+void Polynomial::evaluateAt(const double* x, int n, double* out)const {
+	if (!isValid()) {
+		std::fill(out, out + n, 0.0);
+		return;
+	}
+	const double* c = m_p;
 	int d = getDegree();
-	std::complex<double> f = m_c[0];
-	for (int i = 1; i <= d; ++i) {
-		f+=std::polar(m_c[i], w * i);
+	int k = 0;
+	// LANES points at a time: the lanes are independent, so that the inner loops are vectorized
+	for (; k + EVAL_LANES <= n; k += EVAL_LANES) {
+		double xl[EVAL_LANES], f[EVAL_LANES];
+		for (int l = 0; l < EVAL_LANES; ++l) {
+			xl[l] = x[k + l];
+			f[l] = c[d];
+		}
+		for (int i = d - 1; i >= 0; --i) {
+			double ci = c[i];
+			for (int l = 0; l < EVAL_LANES; ++l)
+				f[l] = f[l] * xl[l] + ci;
+		}
+		for (int l = 0; l < EVAL_LANES; ++l)
+			out[k + l] = f[l];
+	}
+	for (; k < n; ++k) {
+		double xk = x[k], f = c[d];
+		for (int i = d - 1; i >= 0; --i)
+			f = f * xk + c[i];
+		out[k] = f;
 	}
-	return f;
 }
 
-
-const Polynomial Polynomial::ZERO(0, 0.0);
-const Polynomial Polynomial::ONE(0, 1.0);
-
-// w = num/denom or w * denom = num
-void Polynomial::rationalFunctionExpansion(const Polynomial& denom, int n, double* w)const {
-	if (n <= 0)
+void Polynomial::evaluateAt(const double* xr, const double* xi, int n, double* outr, double* outi)const {
+	if (!isValid()) {
+		std::fill(outr, outr + n, 0.0);
+		std::fill(outi, outi + n, 0.0);
 		return;
-	int q = m_c.length();
-	int p = denom.m_c.length();
-	double d = denom[0];
-
-	int imax = std::min(n, q);
-	// trivial case
-	if (p == 1) {
-		if (d != 1) {
-			for (int i = 0; i < imax; ++i) {
-				w[i] = m_c[i] / d;
-			}
+	}
+	const double* c = m_p;
+	int d = getDegree();
+	int k = 0;
+	for (; k + EVAL_LANES <= n; k += EVAL_LANES) {
+		double zr[EVAL_LANES], zi[EVAL_LANES], fr[EVAL_LANES], fi[EVAL_LANES];
+		for (int l = 0; l < EVAL_LANES; ++l) {
+			zr[l] = xr[k + l];
+			zi[l] = xi[k + l];
+			fr[l] = c[d];
+			fi[l] = 0;
 		}
-		else {
-			for (int i = 0; i < imax; ++i) {
-				w[i] = m_c[i];
+		for (int i = d - 1; i >= 0; --i) {
+			double ci = c[i];
+			for (int l = 0; l < EVAL_LANES; ++l) {
+				double tr = fr[l] * zr[l] - fi[l] * zi[l] + ci;
+				fi[l] = fr[l] * zi[l] + fi[l] * zr[l];
+				fr[l] = tr;
 			}
 		}
-		for (int i = imax; i < n; ++i) {
-			w[i] = 0;
+		for (int l = 0; l < EVAL_LANES; ++l) {
+			outr[k + l] = fr[l];
+			outi[k + l] = fi[l];
 		}
-		return;
 	}
-
-	w[0] = m_c[0] / d;
-	// until p...
-	int kmax = std::min(n, p);
-	for (int k = 1; k < kmax; ++k) {
-		double s = 0;
-		for (int l = 1; l <= k; ++l) {
-			s += denom.m_c[l] * w[k - l];
-		}
-		if (k < q) {
-			w[k] = (m_c[k] - s) / d;
-		}
-		else {
-			w[k] = -s / d;
-		}
+	for (; k < n; ++k) {
+		std::complex<double> f = horner(c, m_n, xr[k], xi[k]);
+		outr[k] = f.real();
+		outi[k] = f.imag();
 	}
-	for (int k = kmax; k < imax; ++k) {
-		double s = 0;
-		for (int l = 1; l < p; ++l) {
-			s += denom.m_c[l] * w[k - l];
-		}
-		w[k] = (m_c[k] - s) / d;
+}
+
+std::complex<double> Polynomial::evaluateAtFrequency(double w)const {
+	// one sin/cos, then Horner's rule on exp(i w)
+	return horner(m_p, m_n, std::cos(w), std::sin(w));
+}
+
+void Polynomial::evaluateAtFrequencies(double w0, double dw, int n, std::complex<double>* out)const {
+	if (!isValid()) {
+		std::fill(out, out + n, std::complex<double>(0));
+		return;
 	}
-	for (int k = imax; k < n; ++k) {
-		double s = 0;
-		for (int l = 1; l < p; ++l) {
-			s += denom.m_c[l] * w[k - l];
-		}
-		w[k] = -s / d;
+	frequencyGrid(m_p, m_n, w0, dw, n, [out](int k, const std::complex<double>& f) {out[k] = f; });
+}
+
+void Polynomial::squaredModulusAtFrequencies(double w0, double dw, int n, double* out)const {
+	if (!isValid()) {
+		std::fill(out, out + n, 0.0);
+		return;
 	}
+	frequencyGrid(m_p, m_n, w0, dw, n, [out](int k, const std::complex<double>& f) {out[k] = std::norm(f); });
 }
 
 
+const Polynomial Polynomial::ZERO(0, 0.0);
+const Polynomial Polynomial::ONE(0, 1.0);
 
+// w = num/denom or w * denom = num
+void Polynomial::rationalFunctionExpansion(const Polynomial& denom, int n, double* w)const {
+	if (n <= 0)
+		return;
+	int q = m_n, p = denom.getDegree();
+	double d = denom[0];
+	// b = num/d, ar = reversed denom[1, p]/d
+	SmallBlock<double> b(q), ar(p);
+	for (int i = 0; i < q; ++i)
+		b(i) = m_p[i] / d;
+	for (int j = 0; j < p; ++j)
+		ar(j) = denom.m_p[p - j] / d;
+	RationalExpansion::recurrence(b.data(), q, ar.data(), p, w, 0, n);
+}
@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "polynomialroots.h"
+#include "smallblock.h"
+
+using namespace NUMCPP;
+
+namespace {
+
+	const double TWOPI = 6.283185307179586476925286766559;
+	const double EPS = std::numeric_limits<double>::epsilon();
+
+	// Inline size of the scratch arrays: the roots of the polynomials stored inline
+	// are computed without heap allocation (except by the companion matrix fallback)
+	const int SCRATCH = Polynomial::INLINE_DEGREE + 1;
+
+	// Maximal number of QR iterations by eigenvalue
+	const int HQR_ITERATIONS = 30;
+
+	inline double sign(double a, double b) {
+		return b >= 0 ? std::abs(a) : -std::abs(a);
+	}
+
+	// Square matrix of order n, 1-based (as in the EISPACK routines)
+	class Hessenberg {
+	public:
+		explicit Hessenberg(int n) :m_n(n), m_a((n + 1) * (n + 1), 0.0) {}
+
+		double& operator()(int i, int j) {
+			return m_a[i * (m_n + 1) + j];
+		}
+
+		int order()const {
+			return m_n;
+		}
+
+	private:
+		int m_n;
+		std::vector<double> m_a;
+	};
+
+	// Reduces the norm of the matrix by similarity transformations with powers of 2
+	void balance(Hessenberg& a) {
+		const double RADIX = 2, SQRDX = RADIX * RADIX;
+		int n = a.order();
+		bool done = false;
+		while (!done) {
+			done = true;
+			for (int i = 1; i <= n; ++i) {
+				double r = 0, c = 0;
+				for (int j = 1; j <= n; ++j) {
+					if (j != i) {
+						c += std::abs(a(j, i));
+						r += std::abs(a(i, j));
+					}
+				}
+				if (c != 0 && r != 0) {
+					double g = r / RADIX, f = 1, s = c + r;
+					while (c < g) {
+						f *= RADIX;
+						c *= SQRDX;
+					}
+					g = r * RADIX;
+					while (c > g) {
+						f /= RADIX;
+						c /= SQRDX;
+					}
+					if ((c + r) / f < 0.95 * s) {
+						done = false;
+						g = 1 / f;
+						for (int j = 1; j <= n; ++j)
+							a(i, j) *= g;
+						for (int j = 1; j <= n; ++j)
+							a(j, i) *= f;
+					}
+				}
+			}
+		}
+	}
+
+	// Eigenvalues of an upper Hessenberg matrix (Francis double shift QR, destroys a)
+	bool hqr(Hessenberg& a, std::complex<double>* w) {
+		int n = a.order();
+		double anorm = 0;
+		for (int i = 1; i <= n; ++i)
+			for (int j = std::max(i - 1, 1); j <= n; ++j)
+				anorm += std::abs(a(i, j));
+		int nn = n, l;
+		double t = 0, p = 0, q = 0, r = 0, s, x, y, z, u, v, ww;
+		while (nn >= 1) {
+			int its = 0;
+			do {
+				// looks for a small subdiagonal item
+				for (l = nn; l >= 2; --l) {
+					s = std::abs(a(l - 1, l - 1)) + std::abs(a(l, l));
+					if (s == 0)
+						s = anorm;
+					if (std::abs(a(l, l - 1)) + s == s) {
+						a(l, l - 1) = 0;
+						break;
+					}
+				}
+				x = a(nn, nn);
+				if (l == nn) {
+					// one root
+					w[nn - 1] = std::complex<double>(x + t, 0);
+					--nn;
+				}
+				else {
+					y = a(nn - 1, nn - 1);
+					ww = a(nn, nn - 1) * a(nn - 1, nn);
+					if (l == nn - 1) {
+						// two roots
+						p = 0.5 * (y - x);
+						q = p * p + ww;
+						z = std::sqrt(std::abs(q));
+						x += t;
+						if (q >= 0) {
+							z = p + sign(z, p);
+							double r1 = x + z, r2 = z != 0 ? x - ww / z : r1;
+							w[nn - 2] = std::complex<double>(r1, 0);
+							w[nn - 1] = std::complex<double>(r2, 0);
+						}
+						else {
+							w[nn - 2] = std::complex<double>(x + p, -z);
+							w[nn - 1] = std::complex<double>(x + p, z);
+						}
+						nn -= 2;
+					}
+					else {
+						if (its == HQR_ITERATIONS)
+							return false;
+						if (its == 10 || its == 20) {
+							// exceptional shift
+							t += x;
+							for (int i = 1; i <= nn; ++i)
+								a(i, i) -= x;
+							s = std::abs(a(nn, nn - 1)) + std::abs(a(nn - 1, nn - 2));
+							y = x = 0.75 * s;
+							ww = -0.4375 * s * s;
+						}
+						++its;
+						int m;
+						for (m = nn - 2; m >= l; --m) {
+							z = a(m, m);
+							r = x - z;
+							s = y - z;
+							p = (r * s - ww) / a(m + 1, m) + a(m, m + 1);
+							q = a(m + 1, m + 1) - z - r - s;
+							r = a(m + 2, m + 1);
+							s = std::abs(p) + std::abs(q) + std::abs(r);
+							p /= s;
+							q /= s;
+							r /= s;
+							if (m == l)
+								break;
+							u = std::abs(a(m, m - 1)) * (std::abs(q) + std::abs(r));
+							v = std::abs(p) * (std::abs(a(m - 1, m - 1)) + std::abs(z) + std::abs(a(m + 1, m + 1)));
+							if (u + v == v)
+								break;
+						}
+						for (int i = m + 2; i <= nn; ++i) {
+							a(i, i - 2) = 0;
+							if (i != m + 2)
+								a(i, i - 3) = 0;
+						}
+						// double QR step on the rows l to nn and the columns m to nn
+						for (int k = m; k <= nn - 1; ++k) {
+							if (k != m) {
+								p = a(k, k - 1);
+								q = a(k + 1, k - 1);
+								r = 0;
+								if (k != nn - 1)
+									r = a(k + 2, k - 1);
+								if ((x = std::abs(p) + std::abs(q) + std::abs(r)) != 0) {
+									p /= x;
+									q /= x;
+									r /= x;
+								}
+							}
+							if ((s = sign(std::sqrt(p * p + q * q + r * r), p)) != 0) {
+								if (k == m) {
+									if (l != m)
+										a(k, k - 1) = -a(k, k - 1);
+								}
+								else {
+									a(k, k - 1) = -s * x;
+								}
+								p += s;
+								x = p / s;
+								y = q / s;
+								z = r / s;
+								q /= p;
+								r /= p;
+								for (int j = k; j <= nn; ++j) {
+									p = a(k, j) + q * a(k + 1, j);
+									if (k != nn - 1) {
+										p += r * a(k + 2, j);
+										a(k + 2, j) -= p * z;
+									}
+									a(k + 1, j) -= p * y;
+									a(k, j) -= p * x;
+								}
+								int mmin = nn < k + 3 ? nn : k + 3;
+								for (int i = l; i <= mmin; ++i) {
+									p = x * a(i, k) + y * a(i, k + 1);
+									if (k != nn - 1) {
+										p += z * a(i, k + 2);
+										a(i, k + 2) -= p * r;
+									}
+									a(i, k + 1) -= p * q;
+									a(i, k) -= p;
+								}
+							}
+						}
+					}
+				}
+			} while (l < nn - 1);
+		}
+		return true;
+	}
+
+	// a/b without the inf/NaN handling of std::complex (much faster)
+	inline std::complex<double> cdiv(const std::complex<double>& a, const std::complex<double>& b) {
+		double br = b.real(), bi = b.imag();
+		double n = br * br + bi * bi;
+		return std::complex<double>((a.real() * br + a.imag() * bi) / n, (a.imag() * br - a.real() * bi) / n);
+	}
+
+	bool isFinite(const std::complex<double>& z) {
+		return std::isfinite(z.real()) && std::isfinite(z.imag());
+	}
+}
+
+int PolynomialRoots::roots(const Polynomial& p, std::complex<double>* r, Method method) {
+	if (!p.isValid())
+		return -1;
+	int d = p.getDegree();
+	// effective degree and multiplicity of 0
+	int n = d;
+	while (n >= 0 && p[n] == 0)
+		--n;
+	if (n < 0)
+		return -1;
+	int z = 0;
+	while (p[z] == 0)
+		++z;
+	for (int j = n; j < d; ++j)
+		r[j] = std::complex<double>(std::numeric_limits<double>::infinity(), 0);
+	for (int j = 0; j < z; ++j)
+		r[j] = 0;
+	int m = n - z;
+	if (m == 0)
+		return n;
+	SmallBlock<double, SCRATCH> c(m + 1);
+	for (int i = 0; i <= m; ++i)
+		c(i) = p[z + i];
+	std::complex<double>* rq = r + z;
+	if (m == 1) {
+		rq[0] = -c(0) / c(1);
+		return n;
+	}
+	if (m == 2) {
+		// q = -(b + sign(b) sqrt(b^2 - 4ac))/2 avoids the cancellation
+		double a = c(2), b = c(1), cc = c(0);
+		double delta = b * b - 4 * a * cc;
+		if (delta >= 0) {
+			double q = -0.5 * (b + sign(std::sqrt(delta), b));
+			rq[0] = q / a;
+			rq[1] = q != 0 ? cc / q : 0;
+		}
+		else {
+			double re = -b / (2 * a), im = std::sqrt(-delta) / (2 * std::abs(a));
+			rq[0] = std::complex<double>(re, -im);
+			rq[1] = std::complex<double>(re, im);
+		}
+		return n;
+	}
+	Polynomial q(m, c.data());
+	if (method != Companion && aberth(q, rq))
+		return n;
+	if (method != Aberth && companion(q, rq))
+		return n;
+	for (int j = 0; j < m; ++j)
+		rq[j] = std::complex<double>(std::numeric_limits<double>::quiet_NaN(), 0);
+	return n;
+}
+
+double PolynomialRoots::minModulus(const Polynomial& p) {
+	if (!p.isValid())
+		return 0;
+	int d = p.getDegree();
+	if (d <= 0)
+		return p[0] == 0 ? 0 : std::numeric_limits<double>::infinity();
+	SmallBlock<std::complex<double>, SCRATCH> r(d);
+	int n = roots(p, r.data());
+	if (n < 0)
+		return 0;
+	double rmin = std::numeric_limits<double>::infinity();
+	for (int j = 0; j < n; ++j) {
+		double a = std::abs(r(j));
+		// a failed solve must not be read as a large modulus
+		if (std::isnan(a))
+			return a;
+		rmin = std::min(rmin, a);
+	}
+	return rmin;
+}
+
+bool PolynomialRoots::aberth(const Polynomial& p, std::complex<double>* r) {
+	int m = p.getDegree();
+	SmallBlock<double, SCRATCH> dc(m), ac(m + 1);
+	for (int i = 1; i <= m; ++i)
+		dc(i - 1) = i * p[i];
+	for (int i = 0; i <= m; ++i)
+		ac(i) = std::abs(p[i]);
+	// derivative, and polynomial of the moduli (bound of the rounding errors of Horner's rule)
+	Polynomial dp(m - 1, dc.data()), ap(m, ac.data());
+	// starting points on the circle of radius the geometric mean of the moduli of the roots,
+	// off the real axis
+	double rho = std::pow(std::abs(p[0] / p[m]), 1.0 / m);
+	SmallBlock<double, 8 * SCRATCH> work(8 * m);
+	double* zr = work.data(), * zi = zr + m, * fr = zi + m, * fi = fr + m;
+	double* dr = fi + m, * di = dr + m, * az = di + m, * bound = az + m;
+	for (int k = 0; k < m; ++k) {
+		double a = TWOPI * k / m + 0.4;
+		zr[k] = rho * std::cos(a);
+		zi[k] = rho * std::sin(a);
+	}
+	SmallBlock<char, SCRATCH> converged(m, 0);
+	SmallBlock<std::complex<double>, SCRATCH> next(m);
+	for (int it = 0; it < MAX_ITERATIONS; ++it) {
+		p.evaluateAt(zr, zi, m, fr, fi);
+		dp.evaluateAt(zr, zi, m, dr, di);
+		for (int k = 0; k < m; ++k)
+			az[k] = std::hypot(zr[k], zi[k]);
+		ap.evaluateAt(az, m, bound);
+		bool done = true;
+		for (int i = 0; i < m; ++i) {
+			std::complex<double> zc(zr[i], zi[i]);
+			next(i) = zc;
+			if (converged(i))
+				continue;
+			std::complex<double> f(fr[i], fi[i]), df(dr[i], di[i]);
+			if (!isFinite(f) || !isFinite(df))
+				return false;
+			// |p(z)| below the rounding error of its evaluation
+			if (std::abs(f) <= 4 * m * EPS * bound[i]) {
+				converged(i) = 1;
+				continue;
+			}
+			done = false;
+			// s = sum 1/(z[i] - z[j]), j != i
+			double sr = 0, si = 0;
+			for (int j = 0; j < m; ++j) {
+				if (j != i) {
+					double ur = zr[i] - zr[j], ui = zi[i] - zi[j];
+					double n = ur * ur + ui * ui;
+					sr += ur / n;
+					si -= ui / n;
+				}
+			}
+			std::complex<double> s(sr, si);
+			std::complex<double> w;
+			if (df == 0.0) {
+				w = (1 + az[i]) * 1e-3;
+			}
+			else {
+				std::complex<double> ratio = cdiv(f, df);
+				w = cdiv(ratio, 1.0 - ratio * s);
+			}
+			next(i) = zc - w;
+			if (std::abs(w) <= EPS * az[i])
+				converged(i) = 1;
+		}
+		if (done) {
+			for (int k = 0; k < m; ++k)
+				r[k] = std::complex<double>(zr[k], zi[k]);
+			return true;
+		}
+		for (int k = 0; k < m; ++k) {
+			zr[k] = next(k).real();
+			zi[k] = next(k).imag();
+		}
+	}
+	return false;
+}
+
+bool PolynomialRoots::companion(const Polynomial& p, std::complex<double>* r) {
+	int m = p.getDegree();
+	// z^m + sum c[k]/c[m] z^k: first row -c[m-1]/c[m], ..., -c[0]/c[m], ones below the diagonal
+	Hessenberg a(m);
+	for (int k = 1; k <= m; ++k)
+		a(1, k) = -p[m - k] / p[m];
+	for (int k = 2; k <= m; ++k)
+		a(k, k - 1) = 1;
+	balance(a);
+	if (!hqr(a, r))
+		return false;
+	for (int k = 0; k < m; ++k) {
+		if (!isFinite(r[k]))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,76 @@
+#ifndef __numcpp_polynomialroots_h
+#define __numcpp_polynomialroots_h
+
+#include <complex>
+#include "polynomials.h"
+#include "threadpool.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Roots of real polynomials.
+    /// Two methods are available:
+    ///     Aberth: simultaneous Aberth-Ehrlich iterations; the polynomial and its
+    ///         derivative are evaluated at all the approximations at once (see
+    ///         Polynomial::evaluateAt on split complex arrays)
+    ///     Companion: eigenvalues of the balanced companion matrix (Hessenberg QR)
+    /// Auto uses Aberth and falls back to Companion when the iterations don't converge.
+    /// A polynomial of degree d has d roots; when its highest coefficients are zero,
+    /// the missing roots are infinite (stored as (inf, 0)).
+    /// </summary>
+    class PolynomialRoots {
+    public:
+
+        enum Method {
+            Auto,
+            Aberth,
+            Companion
+        };
+
+        /// <summary>
+        /// Roots of p in roots[0, p.getDegree()[. Returns the number of finite roots,
+        /// which are stored first (-1 if the polynomial is zero or invalid). The roots
+        /// that could not be computed (no convergence, non-finite coefficients) are NaN.
+        /// </summary>
+        static int roots(const Polynomial& p, std::complex<double>* roots, Method method = Auto);
+
+        /// <summary>
+        /// Roots of count polynomials of degree d, with coefficients c[k*(d+1), (k+1)*(d+1)[
+        /// and roots in roots[k*d, (k+1)*d[. The parallel policies process the polynomials
+        /// on the thread pool
+        /// </summary>
+        template <class Policy>
+        static void roots(const Policy& policy, const double* c, int d, int count, std::complex<double>* roots, Method method = Auto);
+
+        /// <summary>
+        /// Smallest modulus of the roots of p (inf for a non-zero constant, NaN if
+        /// the roots could not be computed)
+        /// </summary>
+        static double minModulus(const Polynomial& p);
+
+        // Maximal number of Aberth iterations
+        static const int MAX_ITERATIONS = 100;
+
+    private:
+
+        static bool aberth(const Polynomial& p, std::complex<double>* roots);
+        static bool companion(const Polynomial& p, std::complex<double>* roots);
+    };
+
+    template <class Policy>
+    void PolynomialRoots::roots(const Policy& policy, const double* c, int d, int count, std::complex<double>* r, Method method) {
+        static_assert(execution::is_execution_policy<Policy>::value, "execution policy expected");
+        auto fn = [c, d, r, method](index_t k0, index_t k1) {
+            for (index_t k = k0; k < k1; ++k) {
+                Polynomial p(d, c + k * (d + 1));
+                roots(p, r + k * d, method);
+            }
+        };
+        if (execution::is_parallel(policy) && count > 1)
+            ThreadPool::instance().parallelFor(0, count, 1, fn);
+        else
+            fn(0, count);
+    }
+}
+
+#endif
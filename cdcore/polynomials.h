@@ -3,38 +3,74 @@
 
 #include "rdvector.h"
 #include <sequence.h>
+#include "smallblock.h"
+#include "convolution.h"
+#include "threadpool.h"
 #include <ostream>
 #include <complex>
 
 namespace NUMCPP {
 
+    /// <summary>
+    /// Real polynomial c[0] + c[1] x + ... + c[d] x^d.
+    /// Polynomials of degree up to INLINE_DEGREE (NUMCPP_POLYNOMIAL_INLINE_DEGREE)
+    /// are stored in the object itself; larger ones are stored on the heap and
+    /// shared by the copies (reference count, atomic unless NUMCPP_SINGLE_THREADED
+    /// is defined) until one of them is modified. Immutable polynomials can thus be
+    /// shared between threads without copying their coefficients.
+    /// </summary>
     class Polynomial {
     public:
 
+        static const int INLINE_DEGREE = NUMCPP_POLYNOMIAL_INLINE_DEGREE;
+
         static const Polynomial ZERO, ONE;
 
-        Polynomial() {
+        Polynomial() :m_p(m_local), m_n(0), m_cap(INLINE_DEGREE + 1) {
         }
 
         Polynomial(const Polynomial&);
 
+        Polynomial(Polynomial&&) noexcept;
+
         Polynomial(int degree, double val);
-        Polynomial(int degree, double* pval);
+        Polynomial(int degree, const double* pval);
 
         ~Polynomial();
 
         Polynomial& operator=(const Polynomial&);
 
+        Polynomial& operator=(Polynomial&&) noexcept;
+
         bool isValid()const {
-            return m_c.isValid();
+            return m_n > 0;
         }
 
-        int getDegree()const { return m_c.length()-1; }
+        int getDegree()const { return m_n - 1; }
 
         double operator[](int i) const {
-            return m_c[i];
+            return m_p[i];
+        }
+
+        /// <summary>
+        /// Number of coefficients that can be stored without reallocation
+        /// </summary>
+        int capacity()const {
+            return m_cap;
+        }
+
+        /// <summary>
+        /// True if the coefficients are stored in the object itself
+        /// </summary>
+        bool isInline()const {
+            return m_p == m_local;
         }
 
+        /// <summary>
+        /// True if the coefficients are shared with other polynomials (heap storage only)
+        /// </summary>
+        bool isShared()const;
+
         Polynomial operator*(const Polynomial& r)const;
         Polynomial operator+(const Polynomial& r)const;
         Polynomial operator-(const Polynomial& r)const;
@@ -42,23 +78,99 @@ namespace NUMCPP {
         Polynomial operator-(double a)const;
         Polynomial operator*(double a)const;
         Polynomial operator/(double a)const;
-        Polynomial operator+=(double a){
-            return *this + a;
-        }
-        Polynomial operator-= (double a){
-            return *this - a;
-        }
-        Polynomial operator*=(double a) {
-            return *this * a;
-        }
-        Polynomial operator/=(double a) {
-            return *this / a;
-        }
+
+        /// <summary>
+        /// In-place operators. The coefficients are modified in the current storage when
+        /// it is large enough; otherwise the storage is moved to the heap,
+        /// with a geometric growth when the degree increases.
+        /// </summary>
+        Polynomial& operator+=(const Polynomial& r);
+        Polynomial& operator-=(const Polynomial& r);
+        Polynomial& operator*=(const Polynomial& r);
+        Polynomial& operator+=(double a);
+        Polynomial& operator-=(double a);
+        Polynomial& operator*=(double a);
+        Polynomial& operator/=(double a);
+
+        /// <summary>
+        /// Coefficients of a*b in out, which must hold a.getDegree()+b.getDegree()+1 items
+        /// (out must not overlap the coefficients of a or b).
+        /// Returns the number of coefficients written
+        /// </summary>
+        static int multiplyInto(double* out, const Polynomial& a, const Polynomial& b);
+
+        /// <summary>
+        /// Coefficients of a+b (a-b) in out, which must hold max(degrees)+1 items.
+        /// Returns the number of coefficients written
+        /// </summary>
+        static int addInto(double* out, const Polynomial& a, const Polynomial& b);
+        static int subtractInto(double* out, const Polynomial& a, const Polynomial& b);
+
+        /// <summary>
+        /// Euclidean division a = q b + r, with degree(r) < degree(b) (the zero highest
+        /// coefficients of b are ignored). q and r reuse their current storage: no allocation
+        /// while it is large enough. r may be a; q and r may be any of a and b (temporaries
+        /// are used then), and if q and r are the same object it receives the remainder.
+        /// The results are invalid if b is zero.
+        /// </summary>
+        static void divide(const Polynomial& a, const Polynomial& b, Polynomial& q, Polynomial& r);
+
+        Polynomial operator/(const Polynomial& b)const;
+        Polynomial operator%(const Polynomial& b)const;
+
+        /// <summary>
+        /// Approximate greatest common divisor: product of the factors (1 - x/z) (x for z = 0)
+        /// of the roots z of a that match a root of b within tolerance * max(1, |z|)
+        /// (each root of b matching one root of a at most; the common root is the mean of
+        /// the two). Roots whose imaginary part is below the tolerance are taken as real;
+        /// the complex roots are matched by conjugate pairs (a pair without its conjugate
+        /// is skipped), so that the divisor is real. The matching on the roots is robust
+        /// to the perturbations of the coefficients, unlike Euclid's algorithm.
+        /// Returns ONE when there is no common root. The scratch arrays are inline for
+        /// degrees up to INLINE_DEGREE: no heap allocation then (except by the companion
+        /// matrix, when the Aberth iterations of PolynomialRoots fail).
+        /// </summary>
+        static Polynomial approximateGcd(const Polynomial& a, const Polynomial& b, double tolerance = 1e-6);
 
         double evaluateAt(double x)const;
         std::complex<double> evaluateAt(const std::complex<double>& x)const;
+
+        /// <summary>
+        /// Values at the points x[0, n[, in out[0, n[ (Horner's rule on EVAL_LANES points
+        /// at a time, so that the evaluation is vectorized across the points)
+        /// </summary>
+        void evaluateAt(const double* x, int n, double* out)const;
+
+        /// <summary>
+        /// Values at the complex points xr[k] + i xi[k], k in [0, n[, in outr[k] + i outi[k]
+        /// (split real/imaginary arrays). The outputs may be the inputs
+        /// </summary>
+        void evaluateAt(const double* xr, const double* xi, int n, double* outr, double* outi)const;
+
+        /// <summary>
+        /// Same as above, with the points split in chunks on the thread pool
+        /// for the parallel policies
+        /// </summary>
+        template <class Policy>
+        void evaluateAt(const Policy& policy, const double* x, int n, double* out)const;
+
+        template <class Policy>
+        void evaluateAt(const Policy& policy, const double* xr, const double* xi, int n, double* outr, double* outi)const;
+
+        // Number of points evaluated together by the multi-point evaluations
+        static const int EVAL_LANES = 8;
         std::complex<double> evaluateAtFrequency(double w)const;
 
+        /// <summary>
+        /// P(exp(i w)) (|P(exp(i w))|^2) on the regular grid w = w0 + k dw, k in [0, n[,
+        /// in out[0, n[. Grids of Fourier frequencies (dw = 2 pi/N, w0 multiple of dw)
+        /// use a shared table of exp(2 i pi k/N), or a real FFT of the folded coefficients
+        /// when N is a power of 2 and the FFT is cheaper; other grids use Horner's rule
+        /// with a rotation recurrence on exp(i w).
+        /// </summary>
+        void evaluateAtFrequencies(double w0, double dw, int n, std::complex<double>* out)const;
+        void squaredModulusAtFrequencies(double w0, double dw, int n, double* out)const;
+
         void rationalFunctionExpansion(const Polynomial& denom, int n, double* buffer)const;
 
         friend std::ostream& operator<<(std::ostream& os, const Polynomial& P) {
@@ -73,32 +185,108 @@ namespace NUMCPP {
 
     private:
 
-        _cvector<double> m_c;
+        // Storage for at least n coefficients, which keeps the current ones
+        // (not shared: the result can be modified)
+        double* reserve(int n);
+
+        // Shares the heap block of p
+        void share(const Polynomial& p);
+
+        void assign(const double* c, int n);
+
+        void release();
+
+        const double* coefficients()const {
+            return m_p;
+        }
+
+        // the first m_n items of m_p are the coefficients;
+        // m_p is m_local or a heap block of m_cap items, after a SharedCoefficients header
+        double* m_p;
+        int m_n, m_cap;
+        double m_local[INLINE_DEGREE + 1];
     };
 
+    template <class Policy>
+    void Polynomial::evaluateAt(const Policy& policy, const double* x, int n, double* out)const {
+        static_assert(execution::is_execution_policy<Policy>::value, "execution policy expected");
+        // about PARALLEL_GRAIN multiply-adds by chunk
+        index_t grain = std::max<index_t>(EVAL_LANES, Sequence<double>::PARALLEL_GRAIN / std::max(m_n, 1));
+        if (execution::is_parallel(policy) && n > grain) {
+            ThreadPool::instance().parallelFor(0, n, grain, [this, x, out](index_t i0, index_t i1) {
+                evaluateAt(x + i0, (int)(i1 - i0), out + i0);
+                });
+        }
+        else {
+            evaluateAt(x, n, out);
+        }
+    }
+
+    template <class Policy>
+    void Polynomial::evaluateAt(const Policy& policy, const double* xr, const double* xi, int n, double* outr, double* outi)const {
+        static_assert(execution::is_execution_policy<Policy>::value, "execution policy expected");
+        index_t grain = std::max<index_t>(EVAL_LANES, Sequence<double>::PARALLEL_GRAIN / (4 * std::max(m_n, 1)));
+        if (execution::is_parallel(policy) && n > grain) {
+            ThreadPool::instance().parallelFor(0, n, grain, [this, xr, xi, outr, outi](index_t i0, index_t i1) {
+                evaluateAt(xr + i0, xi + i0, (int)(i1 - i0), outr + i0, outi + i0);
+                });
+        }
+        else {
+            evaluateAt(xr, xi, n, outr, outi);
+        }
+    }
+
 	class Polynomials {
 
     public:
 
+		/// <summary>
+		/// Coefficients of the product of two polynomials. Short products
+		/// (the usual case in ARIMA models) don't allocate.
+		/// </summary>
+		template <typename T>
+		static SmallBlock<T> times(const Sequence<T>& l, const Sequence<T>& r);
+
+	private:
+
 		template <typename T>
-		static DataBlock<T> times(const Sequence<T>& l, const Sequence<T>& r);
+		static SmallBlock<T> schoolbook(const Sequence<T>& l, const Sequence<T>& r);
 	};
 
 	template <typename T>
-	DataBlock<T> Polynomials::times(const Sequence<T>& l, const Sequence<T>& r) {
-        int nl = l.length(), nr = r.length();
-        int d = nl + nr - 1;
-        DataBlock<T> result(d, CONSTANTS<T>::zero);
-        for (int i = 0; i < d; ++i)
-            result(i) = 0;
+	SmallBlock<T> Polynomials::times(const Sequence<T>& l, const Sequence<T>& r) {
+        return schoolbook(l, r);
+	}
+
+	/// <summary>
+	/// Contiguous sequences of long products are multiplied by Karatsuba or FFT
+	/// (see Convolution)
+	/// </summary>
+	template <>
+	inline SmallBlock<double> Polynomials::times(const Sequence<double>& l, const Sequence<double>& r) {
+        index_t nl = l.length(), nr = r.length();
+        if (nl > 0 && nr > 0 && l.increment() == 1 && r.increment() == 1
+            && Convolution::select((int)nl, (int)nr) != Convolution::Schoolbook) {
+            SmallBlock<double> result(nl + nr - 1);
+            Convolution::multiply(l.cstart(), (int)nl, r.cstart(), (int)nr, result.data());
+            return result;
+        }
+        return schoolbook(l, r);
+	}
+
+	template <typename T>
+	SmallBlock<T> Polynomials::schoolbook(const Sequence<T>& l, const Sequence<T>& r) {
+        index_t nl = l.length(), nr = r.length();
+        index_t d = nl + nr - 1;
+        SmallBlock<T> result(d, CONSTANTS<T>::zero);
         auto lbeg=l.cbegin(), lend = l.cend();
         auto rend = r.cend();
-        int il = 0;
+        index_t il = 0;
         while (lbeg != lend) {
             T lcur = *lbeg++;
             if (lcur != CONSTANTS<T>::zero) {
                 auto rbeg = r.cbegin();
-                int ir = 0;
+                index_t ir = 0;
                 while (rbeg != rend) {
                     T rcur = *rbeg++;
                     if (rcur != CONSTANTS<T>::zero) {
@@ -0,0 +1,198 @@
+#ifndef __numcpp_random_h
+#define __numcpp_random_h
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include "config.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Counter-based random number generator (Philox4x32-10, Salmon et al., 2011).
+    /// The generator has no mutable state: the k-th output of a stream is a pure
+    /// function of (seed, stream, k). Any partition of a fill into chunks, serial
+    /// or parallel, yields bit-identical results as long as each chunk is filled
+    /// with its own offset.
+    /// </summary>
+    class Philox {
+    public:
+
+        Philox(uint64_t seed, uint64_t stream = 0) :m_seed(seed), m_stream(stream) {
+        }
+
+        /// <summary>
+        /// Generator seeded from std::random_device (not reproducible)
+        /// </summary>
+        static Philox fromEntropy(uint64_t stream = 0) {
+            std::random_device rd;
+            uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+            return Philox(seed, stream);
+        }
+
+        uint64_t seed()const {
+            return m_seed;
+        }
+
+        uint64_t stream()const {
+            return m_stream;
+        }
+
+        /// <summary>
+        /// Generator of the same seed on another stream
+        /// </summary>
+        Philox substream(uint64_t stream)const {
+            return Philox(m_seed, stream);
+        }
+
+        /// <summary>
+        /// Computes the 4 words of the block identified by counter
+        /// </summary>
+        void block(uint64_t counter, uint32_t* out)const;
+
+        /// <summary>
+        /// x[k*incx] = U(offset+k), k in [0, n[, uniform in ]0, 1[
+        /// </summary>
+        void uniform(uint64_t offset, index_t n, double* x, index_t incx)const;
+
+        /// <summary>
+        /// x[k*incx] = N(offset+k), k in [0, n[, standard normal (Box-Muller)
+        /// </summary>
+        void normal(uint64_t offset, index_t n, double* x, index_t incx)const;
+
+    private:
+
+        // Each block gives 2 doubles (53 bits out of 64)
+        static const int BATCH = 8;
+
+        static const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+        static const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+        static const int ROUNDS = 10;
+
+        void batch(uint64_t counter, double* u)const;
+
+        static double toUniform(uint32_t hi, uint32_t lo) {
+            // (k + 0.5) * 2^-53 lies in ]0, 1[
+            uint64_t k = ((static_cast<uint64_t>(hi) << 32) | lo) >> 11;
+            return (static_cast<double>(k) + 0.5) * (1.0 / 9007199254740992.0);
+        }
+
+        uint64_t m_seed, m_stream;
+    };
+
+    inline void Philox::block(uint64_t counter, uint32_t* out)const {
+        uint32_t c0 = static_cast<uint32_t>(counter), c1 = static_cast<uint32_t>(counter >> 32);
+        uint32_t c2 = static_cast<uint32_t>(m_stream), c3 = static_cast<uint32_t>(m_stream >> 32);
+        uint32_t k0 = static_cast<uint32_t>(m_seed), k1 = static_cast<uint32_t>(m_seed >> 32);
+        for (int r = 0; r < ROUNDS; ++r) {
+            uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+            uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += W0;
+            k1 += W1;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    // Computes BATCH consecutive blocks lane by lane, so that the rounds
+    // vectorize over the lanes; u receives 2*BATCH uniforms.
+    inline void Philox::batch(uint64_t counter, double* u)const {
+        uint32_t c0[BATCH], c1[BATCH], c2[BATCH], c3[BATCH];
+        uint32_t s0 = static_cast<uint32_t>(m_stream), s1 = static_cast<uint32_t>(m_stream >> 32);
+        for (int l = 0; l < BATCH; ++l) {
+            uint64_t cur = counter + l;
+            c0[l] = static_cast<uint32_t>(cur);
+            c1[l] = static_cast<uint32_t>(cur >> 32);
+            c2[l] = s0;
+            c3[l] = s1;
+        }
+        uint32_t k0 = static_cast<uint32_t>(m_seed), k1 = static_cast<uint32_t>(m_seed >> 32);
+        for (int r = 0; r < ROUNDS; ++r) {
+            for (int l = 0; l < BATCH; ++l) {
+                uint64_t p0 = static_cast<uint64_t>(M0) * c0[l];
+                uint64_t p1 = static_cast<uint64_t>(M1) * c2[l];
+                uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+                uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+                c1[l] = static_cast<uint32_t>(p1);
+                c3[l] = static_cast<uint32_t>(p0);
+                c0[l] = n0;
+                c2[l] = n2;
+            }
+            k0 += W0;
+            k1 += W1;
+        }
+        for (int l = 0; l < BATCH; ++l) {
+            u[2 * l] = toUniform(c0[l], c1[l]);
+            u[2 * l + 1] = toUniform(c2[l], c3[l]);
+        }
+    }
+
+    inline void Philox::uniform(uint64_t offset, index_t n, double* x, index_t incx)const {
+        if (n <= 0)
+            return;
+        const int nb = 2 * BATCH;
+        double u[2 * BATCH];
+        // Realign on a batch boundary, so that the values only depend on the position
+        uint64_t pos = offset;
+        index_t i = 0;
+        while (i < n) {
+            uint64_t first = (pos / nb) * nb;
+            int skip = static_cast<int>(pos - first);
+            batch(first / 2, u);
+            int m = static_cast<int>(std::min<index_t>(nb - skip, n - i));
+            if (incx == 1) {
+                for (int j = 0; j < m; ++j)
+                    x[i + j] = u[skip + j];
+            }
+            else {
+                for (int j = 0; j < m; ++j)
+                    x[(i + j) * incx] = u[skip + j];
+            }
+            i += m;
+            pos += m;
+        }
+    }
+
+    inline void Philox::normal(uint64_t offset, index_t n, double* x, index_t incx)const {
+        if (n <= 0)
+            return;
+        const int nb = 2 * BATCH;
+        const double twopi = 6.283185307179586476925286766559;
+        double u[2 * BATCH], z[2 * BATCH];
+        uint64_t pos = offset;
+        index_t i = 0;
+        while (i < n) {
+            uint64_t first = (pos / nb) * nb;
+            int skip = static_cast<int>(pos - first);
+            batch(first / 2, u);
+            for (int l = 0; l < BATCH; ++l) {
+                double r = std::sqrt(-2 * std::log(u[2 * l]));
+                double a = twopi * u[2 * l + 1];
+                z[2 * l] = r * std::cos(a);
+                z[2 * l + 1] = r * std::sin(a);
+            }
+            int m = static_cast<int>(std::min<index_t>(nb - skip, n - i));
+            if (incx == 1) {
+                for (int j = 0; j < m; ++j)
+                    x[i + j] = z[skip + j];
+            }
+            else {
+                for (int j = 0; j < m; ++j)
+                    x[(i + j) * incx] = z[skip + j];
+            }
+            i += m;
+            pos += m;
+        }
+    }
+}
+
+#endif
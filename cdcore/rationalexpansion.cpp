@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "rationalexpansion.h"
+#include "convolution.h"
+
+using namespace NUMCPP;
+
+namespace {
+
+	// Number of independent accumulators of the dot products
+	const int LANES = 4;
+
+	// sum x[i] y[i], i in [0, n[
+	inline double dot(const double* x, const double* y, int n) {
+		double acc[LANES] = { 0 };
+		int i = 0;
+		for (; i + LANES <= n; i += LANES) {
+			for (int l = 0; l < LANES; ++l)
+				acc[l] += x[i + l] * y[i + l];
+		}
+		double s = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+		for (; i < n; ++i)
+			s += x[i] * y[i];
+		return s;
+	}
+}
+
+RationalExpansion::RationalExpansion(const Polynomial& num, const Polynomial& denom) :m_pos(0) {
+	assert(denom.isValid() && denom[0] != 0);
+	double d0 = denom[0];
+	int q = num.isValid() ? num.getDegree() + 1 : 0, p = denom.getDegree();
+	m_b.resize(q);
+	for (int i = 0; i < q; ++i)
+		m_b[i] = num[i] / d0;
+	m_a.resize(p + 1);
+	for (int i = 0; i <= p; ++i)
+		m_a[i] = denom[i] / d0;
+	m_ar.resize(p);
+	for (int j = 0; j < p; ++j)
+		m_ar[j] = m_a[p - j];
+}
+
+void RationalExpansion::recurrence(const double* b, int nb, const double* ar, int p, double* w, int k0, int k1) {
+	// start: only the lags <= k (ar[p-l] = a[l])
+	int kmax = std::min(k1, p);
+	for (int k = k0; k < kmax; ++k) {
+		double s = k < nb ? b[k] : 0;
+		w[k] = s - dot(ar + p - k, w, k);
+	}
+	for (int k = std::max(k0, p); k < k1; ++k) {
+		double s = k < nb ? b[k] : 0;
+		w[k] = s - dot(ar, w + k - p, p);
+	}
+}
+
+const double* RationalExpansion::expand(int n) {
+	int k0 = size();
+	if (n > k0) {
+		int p = (int)m_ar.size();
+		if (n > 1 && NEWTON_COST * double(n) * std::log2(double(n)) < double(n - k0) * p) {
+			newton(n);
+		}
+		else {
+			m_w.resize(n);
+			recurrence(m_b.data(), (int)m_b.size(), m_ar.data(), p, m_w.data(), k0, n);
+		}
+	}
+	return m_w.data();
+}
+
+void RationalExpansion::next(int n, double* buffer) {
+	const double* w = expand(m_pos + n);
+	std::copy(w + m_pos, w + m_pos + n, buffer);
+	m_pos += n;
+}
+
+void RationalExpansion::newton(int n) {
+	int na = std::min((int)m_a.size(), n);
+	// g = 1/a mod z^m, m doubled at each step: a g = 1 + z^m e, g <- g - z^m (g e)
+	std::vector<double> g(n), t(n + na), h(2 * n);
+	g[0] = 1;
+	for (int m = 1; m < n;) {
+		int m2 = std::min(2 * m, n);
+		int la = std::min(na, m2);
+		Convolution::multiply(m_a.data(), la, g.data(), m, t.data());
+		// e[j] = t[m+j], j in [0, m2-m[ (t has la+m-1 items)
+		int ne = std::min(m2 - m, la - 1);
+		if (ne > 0) {
+			Convolution::multiply(g.data(), m2 - m, t.data() + m, ne, h.data());
+			for (int j = 0; j < m2 - m; ++j)
+				g[m + j] = -h[j];
+		}
+		else {
+			std::fill(g.begin() + m, g.begin() + m2, 0.0);
+		}
+		m = m2;
+	}
+	// w = b g mod z^n; the coefficients already computed are kept
+	int k0 = size(), nb = std::min((int)m_b.size(), n);
+	m_w.resize(n);
+	if (nb == 0) {
+		std::fill(m_w.begin() + k0, m_w.end(), 0.0);
+		return;
+	}
+	std::vector<double> w(nb + n - 1);
+	Convolution::multiply(m_b.data(), nb, g.data(), n, w.data());
+	std::copy(w.begin() + k0, w.begin() + n, m_w.begin() + k0);
+}
@@ -0,0 +1,71 @@
+#ifndef __numcpp_rationalexpansion_h
+#define __numcpp_rationalexpansion_h
+
+#include <vector>
+#include "polynomials.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Power series w[0] + w[1] z + ... of num/denom (w * denom = num), computed on demand
+    /// (psi-weights of an ARMA model when num is the MA polynomial and denom the AR one).
+    /// The coefficients already computed are kept, so that an expansion can be extended
+    /// without restarting it. The recurrence w[k] = (num[k] - sum denom[l] w[k-l]) / denom[0]
+    /// is computed as a dot product of the reversed denominator with the last weights
+    /// (contiguous, on independent lanes so that it is vectorized). Long expansions with
+    /// a high-degree denominator are computed by the inversion of denom by Newton's
+    /// iterations (FFT products, see Convolution) when the cost model says it is cheaper.
+    /// denom[0] must not be 0.
+    /// </summary>
+    class RationalExpansion {
+    public:
+
+        RationalExpansion(const Polynomial& num, const Polynomial& denom);
+
+        /// <summary>
+        /// Number of coefficients computed so far
+        /// </summary>
+        int size()const {
+            return (int)m_w.size();
+        }
+
+        /// <summary>
+        /// Computes the coefficients up to n (excluded) if needed and returns them
+        /// (the pointer is valid until the next call that extends the expansion)
+        /// </summary>
+        const double* expand(int n);
+
+        /// <summary>
+        /// Coefficient i (computes the missing ones)
+        /// </summary>
+        double coefficient(int i) {
+            return expand(i + 1)[i];
+        }
+
+        /// <summary>
+        /// Copies the next n coefficients (after the ones returned by the previous calls) in buffer
+        /// </summary>
+        void next(int n, double* buffer);
+
+        /// <summary>
+        /// w[k0, k1[ of the expansion of b/(1 + a[1] z + ... + a[p] z^p), given w[0, k0[.
+        /// ar contains a in reversed order: ar[j] = a[p-j], j in [0, p[.
+        /// Used by Polynomial::rationalFunctionExpansion
+        /// </summary>
+        static void recurrence(const double* b, int nb, const double* ar, int p, double* w, int k0, int k1);
+
+        // Cost of the Newton inversion, in units of n log2(n) multiply-adds of the recurrence
+        static const int NEWTON_COST = 64;
+
+    private:
+
+        void newton(int n);
+
+        // num/denom[0], denom/denom[0] and its reversed coefficients 1 to p
+        std::vector<double> m_b, m_a, m_ar;
+        std::vector<double> m_w;
+        int m_pos;
+    };
+}
+
+#endif
@@ -1,24 +1,87 @@
+#include <atomic>
+#include <cstdint>
 #include "rdvector.h"
 
 using namespace NUMCPP;
 
+namespace {
+
+	// Header stored just before each block: the allocator that owns it, the size
+	// requested to the allocator and the distance between the start of the allocation
+	// and the block (padding for the alignment)
+	struct alignas(16) _blockheader
+	{
+		Allocator* owner;
+		size_t size;
+		size_t offset;
+	};
+
+	std::atomic<Allocator*> g_allocator{ nullptr };
+
+	Allocator* defaultAllocator()
+	{
+		// never destroyed: blocks of static objects may be released at exit
+#ifdef NUMCPP_MALLOC
+		static Allocator* allocator = new MallocAllocator();
+#else
+		static Allocator* allocator = new PoolAllocator();
+#endif
+		return allocator;
+	}
+}
+
 void*
 _vectorallocator::alloc(size_t t)
 {
-	void* rslt;
-	if (t)
+	return alloc(t, alignof(_blockheader));
+}
+
+void*
+_vectorallocator::alloc(size_t t, size_t align)
+{
+	if (t == 0)
+		return 0;
+	assert((align & (align - 1)) == 0);
+	// the allocators give blocks aligned on 16 bytes
+	const size_t base = alignof(_blockheader);
+	if (align < base)
+		align = base;
+	Allocator* owner = &allocator();
+	size_t sz = t + sizeof(_blockheader) + (align - base);
+	void* rslt = owner->allocate(sz);
+	if (rslt == 0)
+		throw memException();
+	uintptr_t start = reinterpret_cast<uintptr_t>(rslt);
+	uintptr_t user = (start + sizeof(_blockheader) + align - 1) & ~static_cast<uintptr_t>(align - 1);
+	_blockheader* header = reinterpret_cast<_blockheader*>(user) - 1;
+	header->owner = owner;
+	header->size = sz;
+	header->offset = static_cast<size_t>(user - start);
+	return reinterpret_cast<void*>(user);
+}
+
+void
+_vectorallocator::free(void* pt)
+{
+	if (pt)
 	{
-		rslt = malloc(t);
-		if (rslt == 0)
-			throw memException();
+		_blockheader* header = static_cast<_blockheader*>(pt) - 1;
+		header->owner->deallocate(static_cast<char*>(pt) - header->offset, header->size);
 	}
-	else
-		rslt = 0;
-	return rslt;
 }
 
 void
-_vectorallocator::free(void* pt) { if (pt) ::free(pt); }
+_vectorallocator::setAllocator(Allocator* allocator)
+{
+	g_allocator.store(allocator, std::memory_order_release);
+}
+
+Allocator&
+_vectorallocator::allocator()
+{
+	Allocator* rslt = g_allocator.load(std::memory_order_acquire);
+	return rslt != nullptr ? *rslt : *defaultAllocator();
+}
 
 const char*
 rdException::what()const throw()
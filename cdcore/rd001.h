@@ -4,6 +4,8 @@
 #include <string>
 #include <stdexcept>
 #include <assert.h>
+#include <atomic>
+#include "config.h"
 
 class rdException: public std::exception
 {
@@ -42,6 +44,73 @@ public:
 	safeptrException() {}
 };
 
+// Reference counter shared by RefCount and the vectors. The counter is atomic
+// (relaxed increments, release decrements with an acquire fence on the last one),
+// so that objects can be shared between threads, unless NUMCPP_SINGLE_THREADED
+// is defined.
+class AtomicCount
+{
+public:
+
+	explicit AtomicCount(unsigned n = 0) :m_n(n) {}
+
+	unsigned get()const;
+	// true if the count is 1; the writes of the previous owners are then visible
+	bool unique()const;
+	unsigned increment();
+	unsigned decrement();
+
+private:
+
+	AtomicCount(const AtomicCount&);
+	AtomicCount& operator=(const AtomicCount&);
+
+#ifdef NUMCPP_SINGLE_THREADED
+	unsigned m_n;
+#else
+	std::atomic<unsigned> m_n;
+#endif
+};
+
+#ifdef NUMCPP_SINGLE_THREADED
+
+inline unsigned
+AtomicCount::get()const { return m_n; }
+
+inline bool
+AtomicCount::unique()const { return m_n == 1; }
+
+inline unsigned
+AtomicCount::increment() { return ++m_n; }
+
+inline unsigned
+AtomicCount::decrement() { return --m_n; }
+
+#else
+
+inline unsigned
+AtomicCount::get()const { return m_n.load(std::memory_order_relaxed); }
+
+inline bool
+AtomicCount::unique()const { return m_n.load(std::memory_order_acquire) == 1; }
+
+inline unsigned
+AtomicCount::increment() { return m_n.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+inline unsigned
+AtomicCount::decrement()
+{
+	unsigned rslt = m_n.fetch_sub(1, std::memory_order_release) - 1;
+	// the writes of the other owners are visible to the one that deletes the object
+	if (rslt == 0)
+		std::atomic_thread_fence(std::memory_order_acquire);
+	return rslt;
+}
+
+#endif
+
+///////////////////////////////////////////////
+
 class RefCount
 {
 
@@ -74,28 +143,28 @@ private:
 	RefCount(const RefCount&);
 	RefCount& operator=(const RefCount&);
 	
-	mutable unsigned m_uRefs;
+	mutable AtomicCount m_uRefs;
 };
 
 inline RefCount::RefCount()
-{m_uRefs=0; }
+{}
 
 inline RefCount::~RefCount()
 {}
 
 inline unsigned
 RefCount::GetRefs()const
-{ return m_uRefs;}
+{ return m_uRefs.get();}
 
 
 inline unsigned
-RefCount::AddRef()const{return ++m_uRefs;}
+RefCount::AddRef()const{return m_uRefs.increment();}
 
 inline unsigned
 RefCount::Release()const
 {
-	assert(m_uRefs);
-	unsigned rslt=--m_uRefs;
+	assert(m_uRefs.get());
+	unsigned rslt=m_uRefs.decrement();
 	if (rslt == 0)
 		DeleteObject();
 	return rslt;
@@ -2,26 +2,39 @@
 #define __rdvector_h
 
 #include "rd001.h"
+#include <new>
+#include <cstdint>
+#include "allocator.h"
 
 //****************************************************************************
 //
-//	Templates  _vector<T> et Vector<T> .
+//	Templates  _vector<T, A> et Vector<T> .
 //
 //****************************************************************************
 
 namespace NUMCPP {
 
-	template<class T> class _vector;
-	template<class T> class _svector;
-	template<class T> class _svp;
-	template<class T> class _cvector;
+	//	A: alignment (en octets) des donnes des vecteurs (NUMCPP_ALIGNMENT par dfaut)
+	template<class T, size_t A = NUMCPP_ALIGNMENT> class _vector;
+	template<class T, size_t A = NUMCPP_ALIGNMENT> class _svector;
+	template<class T, size_t A = NUMCPP_ALIGNMENT> class _svp;
+	template<class T, size_t A = NUMCPP_ALIGNMENT> class _cvector;
 
 	class _vectorallocator
 	{
 	public:
 
 		static void* alloc(size_t);
+		static void* alloc(size_t size, size_t align);
+		//	Bloc align sur align octets (puissance de 2).
 		static void free(void*);
+
+		static void setAllocator(Allocator* allocator);
+		//	Allocateur des allocations suivantes (NULL: allocateur par dfaut,
+		//	PoolAllocator sauf si NUMCPP_MALLOC est dfini). Chaque bloc est
+		//	libr par son allocateur, qui doit lui survivre.
+		static Allocator& allocator();
+		//	Allocateur courant (pour les statistiques).
 	};
 
 	template<class T>
@@ -39,20 +52,23 @@ namespace NUMCPP {
 
 	};
 
-	template <class T>
+	template<class T, size_t A>
 	class _vector
 	{
 	public:
 
+		static const size_t ALIGNMENT = A;
+		//	Les donnes (getPtr(), getCPtr()) sont alignes sur ALIGNMENT octets.
+
 		//	Constructeurs / destructeurs
 
 		_vector();
 		explicit _vector(int sz);
 		//	Alloue la place pour sz lments
-		_vector(const _vector<T>&);
+		_vector(const _vector<T, A>&);
 		//	Constructeur de copie. L'allocateur du copieur peut diffrer de
 		//	l'allocateur du copi!
-		_vector(const _vector<T>&, int first, int sz);
+		_vector(const _vector<T, A>&, int first, int sz);
 		//	Constructeur de copie. L'allocateur du copieur peut diffrer de
 		//	l'allocateur du copi!
 		_vector(const T*, int sz);
@@ -64,7 +80,7 @@ namespace NUMCPP {
 
 		//  Oprateurs
 
-		_vector<T>& operator=(const _vector<T>&);
+		_vector<T, A>& operator=(const _vector<T, A>&);
 		T* getPtr();
 		//	Donne accs en Read/Write au donnes de l'objet.
 		const T* getCPtr()const;
@@ -79,7 +95,7 @@ namespace NUMCPP {
 		//	Nombre d'lments du vecteur.
 		bool isValid()const;
 		//	1 si la mmoire a t initialise, 0 sinon.
-		void captureData(_vector<T>& v);
+		void captureData(_vector<T, A>& v);
 		//	Prend les donnes de v, qui se retrouve vide.
 		void alloc(int);
 		//	Alloue la mmoire  la taille dsire, aprs avoir ventuellement
@@ -89,8 +105,8 @@ namespace NUMCPP {
 
 
 		// pour stl...
-		bool operator==(const _vector<T>& v)const { return _data == v._data; }
-		bool operator<(const _vector<T>& v)const { return _data < v._data; }
+		bool operator==(const _vector<T, A>& v)const { return _data == v._data; }
+		bool operator<(const _vector<T, A>& v)const { return _data < v._data; }
 
 		//		template <class InputIterator, class T> friend void Init(InputIterator i0, int sz, _vector<T>&);
 
@@ -98,23 +114,25 @@ namespace NUMCPP {
 
 		void _init(int);
 		//	Initialisation de la mmoire dans les constructeurs.
+		void _release();
+		//	Destruction des lments et libration de la mmoire.
 
 		_safeT<T>* _data;
 		int _size;
 
-		friend _svp<T>;
-		friend _svector<T>;
-		friend _cvector<T>;
+		friend _svp<T, A>;
+		friend _svector<T, A>;
+		friend _cvector<T, A>;
 	};
 
-	template<class T>
-	inline _vector<T>::_vector() :_data(NULL), _size(0) {}
+	template<class T, size_t A>
+	inline _vector<T, A>::_vector() :_data(NULL), _size(0) {}
 
-	template<class T>
-	inline _vector<T>::_vector(int sz) { _init(sz); }
+	template<class T, size_t A>
+	inline _vector<T, A>::_vector(int sz) { _init(sz); }
 
-	template<class T>
-	_vector<T>::_vector(const _vector<T>& v) :_data(0), _size(0)
+	template<class T, size_t A>
+	_vector<T, A>::_vector(const _vector<T, A>& v) :_data(0), _size(0)
 	{
 		if (v._size)
 		{
@@ -124,58 +142,57 @@ namespace NUMCPP {
 		}
 	}
 
-	template<class T>
-	_vector<T>::_vector(const _vector<T>& v, int first, int sz)
+	template<class T, size_t A>
+	_vector<T, A>::_vector(const _vector<T, A>& v, int first, int sz)
 	{
 		_init(sz);
 		for (int u = 0, w = first; u < _size; u++, w++)
 			_data[u] = v._data[w];
 	}
 
-	template<class T>
-	_vector<T>::_vector(const T* pt, int sz)
+	template<class T, size_t A>
+	_vector<T, A>::_vector(const T* pt, int sz)
 	{
 		_init(sz);
 		for (int u = 0; u < _size; u++)
 			_data[u] = pt[u];
 	}
 
-	template<class T>
-	_vector<T>::_vector(const T& t, int sz)
+	template<class T, size_t A>
+	_vector<T, A>::_vector(const T& t, int sz)
 	{
 		_init(sz);
 		for (int i = 0; i < _size; i++)
 			_data[i] = t;
 	}
 
-	template<class T>
-	inline _vector<T>::~_vector()
+	template<class T, size_t A>
+	inline _vector<T, A>::~_vector()
 	{
-		if (_data != NULL)
-			delete[] _data;
+		_release();
 	}
 
-	template<class T>
-	inline T* _vector<T>::getPtr()
+	template<class T, size_t A>
+	inline T* _vector<T, A>::getPtr()
 	{
 		return reinterpret_cast<T*>(_data);
 	}
 
-	template<class T>
-	inline const T* _vector<T>::getCPtr()const
+	template<class T, size_t A>
+	inline const T* _vector<T, A>::getCPtr()const
 	{
 		return reinterpret_cast<T*>(_data);
 	}
 
 
-	template<class T>
-	inline T& _vector<T>::operator[](int u)const
+	template<class T, size_t A>
+	inline T& _vector<T, A>::operator[](int u)const
 	{
 		assert(u < _size);	return _data[u];
 	}
 
-	template<class T>
-	_vector<T>& _vector<T>::operator=(const _vector<T>& v)
+	template<class T, size_t A>
+	_vector<T, A>& _vector<T, A>::operator=(const _vector<T, A>& v)
 	{
 		if (this != &v)
 		{
@@ -186,55 +203,78 @@ namespace NUMCPP {
 		return *this;
 	}
 
-	template<class T>
-	inline bool _vector<T>::isValid()const
+	template<class T, size_t A>
+	inline bool _vector<T, A>::isValid()const
 	{
 		return _data != NULL;
 	}
 
-	template<class T>
-	inline int _vector<T>::length()const
+	template<class T, size_t A>
+	inline int _vector<T, A>::length()const
 	{
 		return _size;
 	}
 
-	template<class T>
-	void _vector<T>::alloc(int sz)
+	template<class T, size_t A>
+	void _vector<T, A>::alloc(int sz)
 	{
-		if (_data != NULL)
-			delete[] _data;
+		_release();
 		_init(sz);
 	}
 
-	template<class T>
-	void _vector<T>::free()
+	template<class T, size_t A>
+	void _vector<T, A>::free()
 	{
 		if (_data != NULL)
 		{
-			delete[] _data;
+			_release();
 			_data = NULL; _size = 0;
 		}
 	}
 
-	template<class T>
-	void _vector<T>::_init(int sz)
+	template<class T, size_t A>
+	void _vector<T, A>::_init(int sz)
 	{
 		_size = sz;
 		if (_size)
 		{
-			_data = new _safeT<T>[sz];
-			if (_data == 0)
-				throw memException();
+			//	mmoire brute aligne, puis construction des lments
+			void* p = _vectorallocator::alloc(sz * sizeof(_safeT<T>), A);
+			_data = static_cast<_safeT<T>*>(p);
+			int u = 0;
+			try
+			{
+				for (; u < sz; ++u)
+					new (_data + u) _safeT<T>();
+			}
+			catch (...)
+			{
+				while (u > 0)
+					_data[--u].~_safeT<T>();
+				_vectorallocator::free(p);
+				_data = 0; _size = 0;
+				throw;
+			}
 		}
 		else
 			_data = 0;
 	}
 
-	template<class T>
-	void _vector<T>::captureData(_vector<T>& v)
+	template<class T, size_t A>
+	void _vector<T, A>::_release()
 	{
-		if (_data != 0)
-			delete[] _data;
+		if (_data != NULL)
+		{
+			for (int u = 0; u < _size; ++u)
+				_data[u].~_safeT<T>();
+			_vectorallocator::free(_data);
+		}
+	}
+
+	template<class T, size_t A>
+	void _vector<T, A>::captureData(_vector<T, A>& v)
+	{
+		_release();
 		_size = v._size;
 		_data = v._data;
 		v._size = 0;
@@ -243,24 +283,24 @@ namespace NUMCPP {
 
 	///////////////////////////////////////////////////////////
 
-	template <class InputIterator, class T>
-	void initialize(InputIterator i0, int sz, _vector<T>& t)
+	template <class InputIterator, class T, size_t A>
+	void initialize(InputIterator i0, int sz, _vector<T, A>& t)
 	{
 		t.alloc(sz);
 		for (int u = 0; u < sz; ++u, ++i0)
 			t[u] = *i0;
 	}
 
-	template <class InputIterator, class T>
-	void initialize(InputIterator i0, _vector<T>& t)
+	template <class InputIterator, class T, size_t A>
+	void initialize(InputIterator i0, _vector<T, A>& t)
 	{
 		int sz = t.length();
 		for (int u = 0; u < sz; ++u, ++i0)
 			t[u] = *i0;
 	}
 
-	template <class InputIterator, class T>
-	void initialize(InputIterator i0, InputIterator i1, _vector<T>& t)
+	template <class InputIterator, class T, size_t A>
+	void initialize(InputIterator i0, InputIterator i1, _vector<T, A>& t)
 	{
 		int sz = 0;
 		InputIterator itmp = i0;
@@ -280,59 +320,60 @@ namespace NUMCPP {
 	{
 	public:
 
-		_sharedvectorbase() { nrefs = 1; }
+		_sharedvectorbase() :nrefs(1) {}
 		~_sharedvectorbase() {}
 
-		int addRef() { return ++nrefs; }
-		int release() { return --nrefs; }
-		int refCount() { return nrefs; }
+		int addRef() { return static_cast<int>(nrefs.increment()); }
+		int release() { return static_cast<int>(nrefs.decrement()); }
+		int refCount()const { return static_cast<int>(nrefs.get()); }
 
 	private:
 
-		int nrefs;
+		//	Atomique, sauf si NUMCPP_SINGLE_THREADED est dfini.
+		AtomicCount nrefs;
 
 	};
 
-	template <class T>
-	class _vectorrep : public _sharedvectorbase, public _vector<T>
+	template<class T, size_t A>
+	class _vectorrep : public _sharedvectorbase, public _vector<T, A>
 	{
 	private:
 
 		_vectorrep();
 		_vectorrep(int sz);
-		_vectorrep(const _vector<T>& v);
-		_vectorrep(const _vector<T>& v, int first, int size);
+		_vectorrep(const _vector<T, A>& v);
+		_vectorrep(const _vector<T, A>& v, int first, int size);
 		_vectorrep(const T* pt, int sz);
 		_vectorrep(const T& t, int sz);
 
-		friend _svector<T>;
-		friend _svp<T>;
-		friend _cvector<T>;
+		friend _svector<T, A>;
+		friend _svp<T, A>;
+		friend _cvector<T, A>;
 
 	};
 
-	template<class T>
-	inline _vectorrep<T>::_vectorrep() {}
+	template<class T, size_t A>
+	inline _vectorrep<T, A>::_vectorrep() {}
 
-	template<class T>
-	inline _vectorrep<T>::_vectorrep(int sz)
-		:_vector<T>(sz) {}
+	template<class T, size_t A>
+	inline _vectorrep<T, A>::_vectorrep(int sz)
+		:_vector<T, A>(sz) {}
 
-	template<class T>
-	inline _vectorrep<T>::_vectorrep(const _vector<T>& v)
-		: _vector<T>(v) {}
+	template<class T, size_t A>
+	inline _vectorrep<T, A>::_vectorrep(const _vector<T, A>& v)
+		: _vector<T, A>(v) {}
 
-	template<class T>
-	inline _vectorrep<T>::_vectorrep(const _vector<T>& v, int first, int size)
-		: _vector<T>(v, first, size) {}
+	template<class T, size_t A>
+	inline _vectorrep<T, A>::_vectorrep(const _vector<T, A>& v, int first, int size)
+		: _vector<T, A>(v, first, size) {}
 
-	template<class T>
-	inline _vectorrep<T>::_vectorrep(const T* pt, int sz)
-		: _vector<T>(pt, sz) {}
+	template<class T, size_t A>
+	inline _vectorrep<T, A>::_vectorrep(const T* pt, int sz)
+		: _vector<T, A>(pt, sz) {}
 
-	template<class T>
-	inline _vectorrep<T>::_vectorrep(const T& t, int sz)
-		: _vector<T>(t, sz) {}
+	template<class T, size_t A>
+	inline _vectorrep<T, A>::_vectorrep(const T& t, int sz)
+		: _vector<T, A>(t, sz) {}
 
 
 	//**************************************************************************
@@ -346,17 +387,17 @@ namespace NUMCPP {
 	//**************************************************************************
 
 
-	template <class T>
+	template<class T, size_t A>
 	class _cvector
 	{
 	public:
 
-		_cvector() :rep(new _vectorrep<T>()) {}
-		_cvector(const _vector<T>& v);
-		_cvector(_vector<T>& v, bool capture);
-		_cvector(const _cvector<T>& v);
-		_cvector(const _vector<T>& v, int first, int size);
-		_cvector(const _cvector<T>& v, int first, int size);
+		_cvector() :rep(new _vectorrep<T, A>()) {}
+		_cvector(const _vector<T, A>& v);
+		_cvector(_vector<T, A>& v, bool capture);
+		_cvector(const _cvector<T, A>& v);
+		_cvector(const _vector<T, A>& v, int first, int size);
+		_cvector(const _cvector<T, A>& v, int first, int size);
 		_cvector(const T* pt, int sz);
 		_cvector(const T& t, int sz);
 
@@ -364,9 +405,9 @@ namespace NUMCPP {
 
 		//  Oprateurs
 
-		_cvector& operator=(const _cvector<T>&);
+		_cvector& operator=(const _cvector<T, A>&);
 		const T* getCPtr()const { return reinterpret_cast<T*>(rep->_data); }
-		operator const _vector<T>& ()const { return *rep; }
+		operator const _vector<T, A>& ()const { return *rep; }
 		const T& operator[](int u)const;
 
 		//	Fonctions
@@ -375,56 +416,56 @@ namespace NUMCPP {
 		bool isValid()const { return rep->isValid(); }
 
 		// pour stl...
-		bool operator==(const _cvector<T>& v)const { return rep == v.rep; }
-		bool operator<(const _cvector<T>& v)const { return rep < v.rep; }
+		bool operator==(const _cvector<T, A>& v)const { return rep == v.rep; }
+		bool operator<(const _cvector<T, A>& v)const { return rep < v.rep; }
 
 	protected:
 
-		_vectorrep<T>* rep;
+		_vectorrep<T, A>* rep;
 
-		friend _svector<T>;
+		friend _svector<T, A>;
 	};
 
-	template <class T>
-	inline _cvector<T>::_cvector(const _vector<T>& v) :rep(new _vectorrep<T>(v)) {}
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(const _vector<T, A>& v) :rep(new _vectorrep<T, A>(v)) {}
 
-	template <class T>
-	inline _cvector<T>::_cvector(_vector<T>& v, bool capture) : rep(new _vectorrep<T>())
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(_vector<T, A>& v, bool capture) : rep(new _vectorrep<T, A>())
 	{
 		assert(capture);
-		rep->CaptureData(v);
+		rep->captureData(v);
 	}
 
-	template <class T>
-	inline _cvector<T>::_cvector(const _vector<T>& v, int first, int size)
-		:rep(new _vectorrep<T>(v, first, size)) {
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(const _vector<T, A>& v, int first, int size)
+		:rep(new _vectorrep<T, A>(v, first, size)) {
 	}
 
-	template <class T>
-	inline _cvector<T>::_cvector(const _cvector<T>& v, int first, int size)
-		: rep(new _vectorrep<T>(*v.rep, first, size)) {
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(const _cvector<T, A>& v, int first, int size)
+		: rep(new _vectorrep<T, A>(*v.rep, first, size)) {
 	}
 
-	template <class T>
-	inline _cvector<T>::_cvector(const T* pt, int sz)
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(const T* pt, int sz)
 	{
-		rep = new _vectorrep<T>(pt, sz);
+		rep = new _vectorrep<T, A>(pt, sz);
 	}
 
-	template <class T>
-	inline _cvector<T>::_cvector(const T& t, int sz)
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(const T& t, int sz)
 	{
-		rep = new _vectorrep<T>(t, sz);
+		rep = new _vectorrep<T, A>(t, sz);
 	}
 
-	template <class T>
-	inline _cvector<T>::_cvector(const _cvector<T>& v)
+	template<class T, size_t A>
+	inline _cvector<T, A>::_cvector(const _cvector<T, A>& v)
 	{
 		rep = v.rep; rep->addRef();
 	}
 
-	template <class T>
-	_cvector<T>& _cvector<T>::operator=(const _cvector<T>& v)
+	template<class T, size_t A>
+	_cvector<T, A>& _cvector<T, A>::operator=(const _cvector<T, A>& v)
 	{
 		if (rep != v.rep)
 		{
@@ -435,8 +476,8 @@ namespace NUMCPP {
 		return *this;
 	}
 
-	template <class T>
-	inline const T& _cvector<T>::operator[](int u)const
+	template<class T, size_t A>
+	inline const T& _cvector<T, A>::operator[](int u)const
 	{
 		assert(u < rep->_size);
 		return rep->_data[u];
@@ -446,117 +487,124 @@ namespace NUMCPP {
 
 	//******************************************************************************
 
-	template <class T>
+	template<class T, size_t A>
 	class _svector
 	{
 	public:
 
-		friend class _svp<T>;
+		friend class _svp<T, A>;
 
 		_svector();
 		explicit _svector(int sz);
-		_svector(const _svector<T>& v);
-		_svector(const _cvector<T>& v);
-		_svector(const _vector<T>& v);
+		_svector(const _svector<T, A>& v);
+		_svector(const _cvector<T, A>& v);
+		_svector(const _vector<T, A>& v);
 		_svector(const T* pt, int sz);
 		_svector(const T& t, int sz);
-		_svector(const _vector<T>& v, int first, int size);
-		_svector(const _cvector<T>& v, int first, int size);
-		_svector(const _svector<T>& v, int first, int size);
+		_svector(const _vector<T, A>& v, int first, int size);
+		_svector(const _cvector<T, A>& v, int first, int size);
+		_svector(const _svector<T, A>& v, int first, int size);
 
 		~_svector() { if (rep->release() == 0) delete rep; }
 
 		//  Oprateurs
 
-		_svector& operator=(const _svector<T>&);
+		_svector& operator=(const _svector<T, A>&);
 		T operator[](int u)const;
-		_svp<T> operator[](int u);
+		_svp<T, A> operator[](int u);
+		T* getPtr();
+		//	Accs en Read/Write: les donnes sont d'abord copies si elles
+		//	sont partages.
+		const T* getCPtr()const { return rep->getCPtr(); }
+		//	Accs en Read, sans copie.
 
 		//	Fonctions
 
-		int length()const { return rep->Size(); }
+		int length()const { return rep->length(); }
 		bool isValid()const { return rep->isValid(); }
+		int refCount()const { return rep->refCount(); }
+		//	Nombre d'objets partageant les donnes.
 		void alloc(int u);
 		void free();
 
-		bool operator==(const _svector<T>& v)const { return rep == v.rep; }
-		bool operator<(const _svector<T>& v)const { return rep < v.rep; }
+		bool operator==(const _svector<T, A>& v)const { return rep == v.rep; }
+		bool operator<(const _svector<T, A>& v)const { return rep < v.rep; }
 
 	protected:
 
-		_vectorrep<T>* rep;
+		_vectorrep<T, A>* rep;
 
 		void clone();
 
 	};
 
-	template <class T>
+	template<class T, size_t A>
 	class _svp
 	{
 	public:
 
-		friend class _svector<T>;
+		friend class _svector<T, A>;
 
 		operator T& ()const { return _sv.rep->_data[_index]; }
 		_svp& operator=(const T& t);
 
 	private:
 
-		_svp(_svector<T>& sv, int index) :_sv(sv), _index(index) {}
+		_svp(_svector<T, A>& sv, int index) :_sv(sv), _index(index) {}
 
-		_svector<T>& _sv;
+		_svector<T, A>& _sv;
 		int _index;
 
 	};
 
 
-	template <class T>
-	inline _svector<T>::_svector() :rep(new _vectorrep<T>()) {}
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector() :rep(new _vectorrep<T, A>()) {}
 
-	template <class T>
-	inline _svector<T>::_svector(int sz) : rep(new _vectorrep<T>(sz)) {}
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(int sz) : rep(new _vectorrep<T, A>(sz)) {}
 
-	template <class T>
-	inline _svector<T>::_svector(const T* pt, int sz) : rep(new _vectorrep<T>(pt, sz)) {}
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const T* pt, int sz) : rep(new _vectorrep<T, A>(pt, sz)) {}
 
-	template <class T>
-	inline _svector<T>::_svector(const T& t, int sz) : rep(new _vectorrep<T>(t, sz)) {}
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const T& t, int sz) : rep(new _vectorrep<T, A>(t, sz)) {}
 
-	template <class T>
-	inline _svector<T>::_svector(const _vector<T>& v, int first, int size)
-		: rep(new _vectorrep<T>(v, first, size)) {
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const _vector<T, A>& v, int first, int size)
+		: rep(new _vectorrep<T, A>(v, first, size)) {
 	}
 
-	template <class T>
-	inline _svector<T>::_svector(const _svector<T>& v, int first, int size)
-		: rep(new _vectorrep<T>(*v.rep, first, size)) {
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const _svector<T, A>& v, int first, int size)
+		: rep(new _vectorrep<T, A>(*v.rep, first, size)) {
 	}
 
-	template <class T>
-	inline _svector<T>::_svector(const _cvector<T>& v, int first, int size)
-		: rep(new _vectorrep<T>(*v.rep, first, size)) {
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const _cvector<T, A>& v, int first, int size)
+		: rep(new _vectorrep<T, A>(*v.rep, first, size)) {
 	}
 
-	template <class T>
-	inline _svector<T>::_svector(const _svector<T>& v)
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const _svector<T, A>& v)
 	{
 		rep = v.rep; rep->addRef();
 	}
 
-	template <class T>
-	inline _svector<T>::_svector(const _cvector<T>& v)
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const _cvector<T, A>& v)
 	{
 		rep = v.rep; rep->addRef();
 	}
 
-	template <class T>
-	inline _svector<T>::_svector(const _vector<T>& v)
+	template<class T, size_t A>
+	inline _svector<T, A>::_svector(const _vector<T, A>& v)
 	{
-		rep = new _vectorrep<T>(v);
+		rep = new _vectorrep<T, A>(v);
 	}
 
-	template <class T>
-	_svector<T>& _svector<T>::operator=(const _svector<T>& v)
+	template<class T, size_t A>
+	_svector<T, A>& _svector<T, A>::operator=(const _svector<T, A>& v)
 	{
 		if (rep != v.rep)
 		{
@@ -567,54 +615,63 @@ namespace NUMCPP {
 		return *this;
 	}
 
-	template <class T>
-	inline void _svector<T>::clone()
+	template<class T, size_t A>
+	inline void _svector<T, A>::clone()
 	{
 		if (rep->refCount() > 1)
 		{
-			rep->release();
-			rep = new _vectorrep<T>(*rep);
+			//	Copie des donnes avant de librer rep (les autres propritaires
+			//	peuvent le dtruire entre-temps); le compteur n'est pas copi.
+			_vectorrep<T, A>* nrep = new _vectorrep<T, A>(static_cast<const _vector<T, A>&>(*rep));
+			if (rep->release() == 0) delete rep;
+			rep = nrep;
 		}
 	}
 
-	template <class T>
-	void _svector<T>::alloc(int u)
+	template<class T, size_t A>
+	inline T* _svector<T, A>::getPtr()
+	{
+		clone(); return rep->getPtr();
+	}
+
+	template<class T, size_t A>
+	void _svector<T, A>::alloc(int u)
 	{
 		clone();
-		rep->Alloc(u);
+		rep->alloc(u);
 	}
 
-	template <class T>
-	void _svector<T>::free()
+	template<class T, size_t A>
+	void _svector<T, A>::free()
 	{
 		if (rep->refCount() > 1)
 		{
-			rep->release();
-			rep = new _vectorrep<T>();
+			if (rep->release() == 0) delete rep;
+			rep = new _vectorrep<T, A>();
 		}
 		else
-			rep->Free();
+			rep->free();
 	}
 
-	template <class T>
-	inline _svp<T>& _svp<T>::operator=(const T& t)
+	template<class T, size_t A>
+	inline _svp<T, A>& _svp<T, A>::operator=(const T& t)
 	{
 		_sv.clone(); _sv.rep->_data[_index] = t; return *this;
 	}
 
 
-	template <class T>
-	T _svector<T>::operator[](int u)const
+	template<class T, size_t A>
+	T _svector<T, A>::operator[](int u)const
 	{
-		assert(u >= rep->_size);
+		assert(u < rep->_size);
 		return rep->_data[u];
 	}
 
-	template <class T>
-	_svp<T> _svector<T>::operator[](int u)
+	template<class T, size_t A>
+	_svp<T, A> _svector<T, A>::operator[](int u)
 	{
-		assert(u >= rep->_size);
-		return _svp<T>(*this, u);
+		assert(u < rep->_size);
+		return _svp<T, A>(*this, u);
 	}
 
 }
@@ -0,0 +1,359 @@
+#ifndef __numcpp_reductions_h
+#define __numcpp_reductions_h
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "config.h"
+#include "threadpool.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Accuracy/reproducibility mode of the sums and dot products
+    /// Fast: plain loop
+    /// Reproducible: fixed-tree pairwise summation, bit-identical whatever the
+    /// number of threads or the SIMD width (provided that the compiler neither
+    /// reassociates nor contracts floating-point operations: no fast-math, no fp-contract)
+    /// Compensated: compensated (Kahan-Neumaier) summation, for sums with large
+    /// offsets or cancellations
+    /// </summary>
+    enum class Summation {
+        Fast, Reproducible, Compensated
+    };
+
+    /// <summary>
+    /// Low-level reduction kernels on strided arrays (x[0], x[incx], ..., x[(n-1)*incx]).
+    /// The kernels are written with independent lanes, without intrinsics,
+    /// so that the compiler can map them on the available SIMD instructions.
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    template <typename T>
+    struct Reductions {
+
+        static const int LANES = 8;
+
+        /// <summary>
+        /// Index of the first maximum (-1 if n == 0). NaN are ignored,
+        /// except when they are the first item
+        /// </summary>
+        static index_t imax(index_t n, const T* x, index_t incx) {
+            return search(n, x, incx, Identity(), Greater());
+        }
+
+        /// <summary>
+        /// Index of the first minimum (-1 if n == 0)
+        /// </summary>
+        static index_t imin(index_t n, const T* x, index_t incx) {
+            return search(n, x, incx, Identity(), Less());
+        }
+
+        /// <summary>
+        /// Index of the first maximum in absolute value (-1 if n == 0)
+        /// </summary>
+        static index_t iamax(index_t n, const T* x, index_t incx) {
+            return search(n, x, incx, Abs(), Greater());
+        }
+
+        /// <summary>
+        /// Multi-threaded versions (shared thread pool). The range is split in nthreads
+        /// contiguous chunks (nthreads <= 0 means one chunk by thread of the pool);
+        /// the result is identical to the serial one (same tie-breaking).
+        /// </summary>
+        static index_t imax(index_t n, const T* x, index_t incx, int nthreads) {
+            return psearch(n, x, incx, Identity(), Greater(), nthreads);
+        }
+
+        static index_t imin(index_t n, const T* x, index_t incx, int nthreads) {
+            return psearch(n, x, incx, Identity(), Less(), nthreads);
+        }
+
+        static index_t iamax(index_t n, const T* x, index_t incx, int nthreads) {
+            return psearch(n, x, incx, Abs(), Greater(), nthreads);
+        }
+
+        /// <summary>
+        /// Minimal length of a chunk in the multi-threaded searches
+        /// </summary>
+        static const int PARALLEL_CHUNK = 1 << 16;
+
+        /// <summary>
+        /// Reproducible sum of x. The items are split in blocks of BLOCK items;
+        /// each block is summed on LANES interleaved accumulators, which are merged
+        /// by a fixed tree, and the blocks are combined by a pairwise tree that only
+        /// depends on n. Long arrays are processed on the thread pool, without any
+        /// effect on the result.
+        /// </summary>
+        static T rsum(index_t n, const T* x, index_t incx) {
+            if (incx == 1)
+                return reproducible(n, [x](index_t i) {return x[i]; });
+            else
+                return reproducible(n, [x, incx](index_t i) {return x[i * incx]; });
+        }
+
+        /// <summary>
+        /// Reproducible sum of squares
+        /// </summary>
+        static T rssq(index_t n, const T* x, index_t incx) {
+            if (incx == 1)
+                return reproducible(n, [x](index_t i) {return x[i] * x[i]; });
+            else
+                return reproducible(n, [x, incx](index_t i) {T cur = x[i * incx]; return cur * cur; });
+        }
+
+        /// <summary>
+        /// Reproducible dot product
+        /// </summary>
+        static T rdot(index_t n, const T* x, index_t incx, const T* y, index_t incy) {
+            if (incx == 1 && incy == 1)
+                return reproducible(n, [x, y](index_t i) {return x[i] * y[i]; });
+            else
+                return reproducible(n, [x, incx, y, incy](index_t i) {return x[i * incx] * y[i * incy]; });
+        }
+
+        /// <summary>
+        /// Compensated sum of x. Each lane carries its own running error,
+        /// so that the loop vectorizes; lanes and errors are merged at the end.
+        /// </summary>
+        static T csum(index_t n, const T* x, index_t incx) {
+            if (incx == 1)
+                return compensated(n, [x](index_t i) {return x[i]; });
+            else
+                return compensated(n, [x, incx](index_t i) {return x[i * incx]; });
+        }
+
+        /// <summary>
+        /// Compensated sum of squares
+        /// </summary>
+        static T cssq(index_t n, const T* x, index_t incx) {
+            if (incx == 1)
+                return compensated(n, [x](index_t i) {return x[i] * x[i]; });
+            else
+                return compensated(n, [x, incx](index_t i) {T cur = x[i * incx]; return cur * cur; });
+        }
+
+        /// <summary>
+        /// Compensated dot product. The products are rounded once;
+        /// their summation is compensated.
+        /// </summary>
+        static T cdot(index_t n, const T* x, index_t incx, const T* y, index_t incy) {
+            if (incx == 1 && incy == 1)
+                return compensated(n, [x, y](index_t i) {return x[i] * y[i]; });
+            else
+                return compensated(n, [x, incx, y, incy](index_t i) {return x[i * incx] * y[i * incy]; });
+        }
+
+        static const int BLOCK = 2048;
+
+        /// <summary>
+        /// Minimal length for the multi-threaded reproducible reductions
+        /// </summary>
+        static const int PARALLEL_SUM = 1 << 18;
+
+    private:
+
+        // s + v = t + error, t being the rounded sum (branch-free TwoSum of Knuth,
+        // equivalent to the Neumaier correction)
+        static T twoSumError(T s, T v, T t) {
+            T z = t - s;
+            return (s - (t - z)) + (v - z);
+        }
+
+        template <class Term>
+        static T compensated(index_t n, Term term) {
+            T s[LANES], c[LANES];
+            for (int l = 0; l < LANES; ++l) {
+                s[l] = T();
+                c[l] = T();
+            }
+            index_t i = 0, imax = (n / LANES) * LANES;
+            for (; i < imax; i += LANES) {
+                for (int l = 0; l < LANES; ++l) {
+                    T v = term(i + l);
+                    T t = s[l] + v;
+                    c[l] += twoSumError(s[l], v, t);
+                    s[l] = t;
+                }
+            }
+            T sum = T(), err = T();
+            for (int l = 0; l < LANES; ++l) {
+                T t = sum + s[l];
+                err += twoSumError(sum, s[l], t) + c[l];
+                sum = t;
+            }
+            for (; i < n; ++i) {
+                T v = term(i);
+                T t = sum + v;
+                err += twoSumError(sum, v, t);
+                sum = t;
+            }
+            return sum + err;
+        }
+
+        template <class Term>
+        static T reproducible(index_t n, Term term) {
+            if (n <= 0)
+                return T();
+            index_t nb = (n + BLOCK - 1) / BLOCK;
+            if (nb == 1)
+                return block(0, n, term);
+            if (n < PARALLEL_SUM || ThreadPool::instance().concurrency() == 1)
+                return tree(0, nb, n, term);
+            std::vector<T> partial(nb);
+            ThreadPool::instance().parallelFor(0, nb, 1, [&partial, n, &term](index_t b0, index_t b1) {
+                for (index_t b = b0; b < b1; ++b)
+                    partial[b] = block(b * BLOCK, std::min(n, (b + 1) * BLOCK), term);
+                });
+            return tree(0, nb, partial.data());
+        }
+
+        // Pairwise combination of the blocks [b0, b1[
+        template <class Term>
+        static T tree(index_t b0, index_t b1, index_t n, const Term& term) {
+            if (b1 - b0 == 1)
+                return block(b0 * BLOCK, std::min(n, b1 * BLOCK), term);
+            index_t mid = b0 + (b1 - b0) / 2;
+            return tree(b0, mid, n, term) + tree(mid, b1, n, term);
+        }
+
+        // Same tree, on precomputed blocks
+        static T tree(index_t b0, index_t b1, const T* partial) {
+            if (b1 - b0 == 1)
+                return partial[b0];
+            index_t mid = b0 + (b1 - b0) / 2;
+            return tree(b0, mid, partial) + tree(mid, b1, partial);
+        }
+
+        template <class Term>
+        static T block(index_t i0, index_t i1, const Term& term) {
+            T acc[LANES];
+            for (int l = 0; l < LANES; ++l)
+                acc[l] = T();
+            index_t i = i0, imax = i0 + ((i1 - i0) / LANES) * LANES;
+            for (; i < imax; i += LANES) {
+                for (int l = 0; l < LANES; ++l)
+                    acc[l] += term(i + l);
+            }
+            for (int h = LANES / 2; h > 0; h /= 2) {
+                for (int l = 0; l < h; ++l)
+                    acc[l] += acc[l + h];
+            }
+            T s = acc[0];
+            for (; i < i1; ++i)
+                s += term(i);
+            return s;
+        }
+
+        struct Identity {
+            T operator()(T x)const { return x; }
+        };
+
+        struct Abs {
+            T operator()(T x)const { return std::abs(x); }
+        };
+
+        struct Greater {
+            bool operator()(T l, T r)const { return l > r; }
+        };
+
+        struct Less {
+            bool operator()(T l, T r)const { return l < r; }
+        };
+
+        template <class Fn, class Cmp>
+        static index_t search(index_t n, const T* x, index_t incx, Fn fn, Cmp better) {
+            if (n < 1)
+                return -1;
+            if (n == 1)
+                return 0;
+            T best = fn(x[0]);
+            index_t ibest = 0;
+            search(1, n, x, incx, fn, better, best, ibest);
+            return ibest;
+        }
+
+        // Scans the items [i0, i1[, starting from the current best (best, ibest).
+        // Each lane keeps its own best item; an item replaces the lane's best only
+        // if it is strictly better, so that each lane holds its first best. The
+        // lanes are then merged by value and, in case of ties, by smallest index,
+        // which reproduces the serial scan.
+        template <class Fn, class Cmp>
+        static void search(index_t i0, index_t i1, const T* x, index_t incx, Fn fn, Cmp better, T& best, index_t& ibest) {
+            index_t i = i0;
+            if (i1 - i0 >= 2 * LANES) {
+                T v[LANES];
+                index_t idx[LANES];
+                for (int l = 0; l < LANES; ++l) {
+                    v[l] = best;
+                    idx[l] = ibest;
+                }
+                index_t imax = i0 + ((i1 - i0) / LANES) * LANES;
+                if (incx == 1) {
+                    for (; i < imax; i += LANES) {
+                        for (int l = 0; l < LANES; ++l) {
+                            T cur = fn(x[i + l]);
+                            bool b = better(cur, v[l]);
+                            v[l] = b ? cur : v[l];
+                            idx[l] = b ? i + l : idx[l];
+                        }
+                    }
+                }
+                else {
+                    for (; i < imax; i += LANES) {
+                        const T* xi = x + i * incx;
+                        for (int l = 0; l < LANES; ++l) {
+                            T cur = fn(xi[l * incx]);
+                            bool b = better(cur, v[l]);
+                            v[l] = b ? cur : v[l];
+                            idx[l] = b ? i + l : idx[l];
+                        }
+                    }
+                }
+                for (int l = 0; l < LANES; ++l) {
+                    if (better(v[l], best) || (v[l] == best && idx[l] < ibest)) {
+                        best = v[l];
+                        ibest = idx[l];
+                    }
+                }
+            }
+            for (; i < i1; ++i) {
+                T cur = fn(x[i * incx]);
+                if (better(cur, best)) {
+                    best = cur;
+                    ibest = i;
+                }
+            }
+        }
+
+        template <class Fn, class Cmp>
+        static index_t psearch(index_t n, const T* x, index_t incx, Fn fn, Cmp better, int nthreads) {
+            if (nthreads <= 0)
+                nthreads = ThreadPool::instance().concurrency();
+            if (nthreads > n / PARALLEL_CHUNK)
+                nthreads = static_cast<int>(n / PARALLEL_CHUNK);
+            if (nthreads <= 1)
+                return search(n, x, incx, fn, better);
+            // All the chunks start from the first item, like the lanes of the serial kernel
+            T first = fn(x[0]);
+            std::vector<T> best(nthreads, first);
+            std::vector<index_t> ibest(nthreads, 0);
+            index_t q = n / nthreads;
+            ThreadPool::instance().run(nthreads, [=, &best, &ibest](int k) {
+                index_t i0 = k == 0 ? 1 : k * q, i1 = k == nthreads - 1 ? n : (k + 1) * q;
+                search(i0, i1, x, incx, fn, better, best[k], ibest[k]);
+                });
+            T b = best[0];
+            index_t ib = ibest[0];
+            // chunks are ordered: strict comparison keeps the first best
+            for (int k = 1; k < nthreads; ++k) {
+                if (better(best[k], b)) {
+                    b = best[k];
+                    ib = ibest[k];
+                }
+            }
+            return ib;
+        }
+    };
+}
+
+#endif
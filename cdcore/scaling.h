@@ -0,0 +1,84 @@
+#ifndef __numcpp_scaling_h
+#define __numcpp_scaling_h
+
+#include <cmath>
+#include "config.h"
+#include "constants.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Scaling kernels on strided arrays (x[0], x[incx], ..., x[(n-1)*incx]),
+    /// shared by Sequence and the LCPP routines.
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    template <typename T>
+    struct Scaling {
+
+        /// <summary>
+        /// x = a * x
+        /// </summary>
+        static void scal(index_t n, T a, T* x, index_t incx);
+
+        /// <summary>
+        /// x = x / d. The division is replaced by a multiplication by 1/d when
+        /// |d| >= safe_min (1/d is then finite) and exact is false; otherwise the
+        /// items are divided one by one.
+        /// </summary>
+        static void div(index_t n, T d, T* x, index_t incx, bool exact = false);
+
+    private:
+
+        static void set(index_t n, T a, T* x, index_t incx);
+    };
+
+    template <typename T>
+    void Scaling<T>::set(index_t n, T a, T* x, index_t incx) {
+        if (incx == 1) {
+            for (index_t i = 0; i < n; ++i)
+                x[i] = a;
+        }
+        else {
+            for (index_t i = 0; i < n; ++i)
+                x[i * incx] = a;
+        }
+    }
+
+    template <typename T>
+    void Scaling<T>::scal(index_t n, T a, T* x, index_t incx) {
+        if (n <= 0 || a == CONSTANTS<T>::one)
+            return;
+        if (a == CONSTANTS<T>::zero) {
+            set(n, a, x, incx);
+            return;
+        }
+        if (incx == 1) {
+            for (index_t i = 0; i < n; ++i)
+                x[i] *= a;
+        }
+        else {
+            for (index_t i = 0; i < n; ++i)
+                x[i * incx] *= a;
+        }
+    }
+
+    template <typename T>
+    void Scaling<T>::div(index_t n, T d, T* x, index_t incx, bool exact) {
+        if (n <= 0 || d == CONSTANTS<T>::one)
+            return;
+        if (!exact && std::abs(d) >= CONSTANTS<T>::safe_min) {
+            scal(n, CONSTANTS<T>::one / d, x, incx);
+            return;
+        }
+        if (incx == 1) {
+            for (index_t i = 0; i < n; ++i)
+                x[i] /= d;
+        }
+        else {
+            for (index_t i = 0; i < n; ++i)
+                x[i * incx] /= d;
+        }
+    }
+}
+
+#endif
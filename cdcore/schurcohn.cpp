@@ -0,0 +1,60 @@
+#include <cmath>
+#include <limits>
+#include "schurcohn.h"
+
+using namespace NUMCPP;
+
+bool SchurCohn::stepDown(double* phi, int d, double* pacf) {
+	for (int k = d; k >= 1; --k) {
+		double a = phi[k - 1];
+		if (pacf)
+			pacf[k - 1] = a;
+		if (!(std::abs(a) < 1)) {
+			if (pacf) {
+				for (int j = 0; j < k - 1; ++j)
+					pacf[j] = std::numeric_limits<double>::quiet_NaN();
+			}
+			return false;
+		}
+		// phi(k-1)j = (phi(k)j + a phi(k)(k-j)) / (1 - a^2), j in [1, k[, by pairs (j, k-j)
+		double s = 1 / (1 - a * a);
+		for (int i = 0, j = k - 2; i <= j; ++i, --j) {
+			double pi = phi[i], pj = phi[j];
+			phi[i] = (pi + a * pj) * s;
+			phi[j] = (pj + a * pi) * s;
+		}
+	}
+	return true;
+}
+
+bool SchurCohn::test(const double* c, int d, double* pacf) {
+	if (d <= 0)
+		return c[0] != 0;
+	if (c[0] == 0) {
+		if (pacf) {
+			for (int j = 0; j < d; ++j)
+				pacf[j] = std::numeric_limits<double>::quiet_NaN();
+		}
+		return false;
+	}
+	SmallBlock<double> phi(d);
+	double* p = phi.data();
+	double s = -1 / c[0];
+	for (int j = 0; j < d; ++j)
+		p[j] = c[j + 1] * s;
+	return stepDown(p, d, pacf);
+}
+
+bool SchurCohn::reflectionCoefficients(const Polynomial& p, double* pacf) {
+	if (!p.isValid())
+		return false;
+	int d = p.getDegree();
+	SmallBlock<double> c(d + 1);
+	for (int i = 0; i <= d; ++i)
+		c(i) = p[i];
+	return test(c.data(), d, pacf);
+}
+
+bool SchurCohn::isStable(const Polynomial& p) {
+	return reflectionCoefficients(p, nullptr);
+}
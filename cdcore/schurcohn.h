@@ -0,0 +1,68 @@
+#ifndef __numcpp_schurcohn_h
+#define __numcpp_schurcohn_h
+
+#include "polynomials.h"
+#include "threadpool.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Schur-Cohn stability test: are all the roots of a real polynomial outside the
+    /// unit circle? The polynomial is written c0 (1 - phi1 z - ... - phip z^p) and the
+    /// Levinson recursion is run backwards (step-down), from the order p to the order 1.
+    /// The coefficient phik of the polynomial of order k is its reflection coefficient
+    /// (the partial autocorrelation of lag k of the AR model); the roots are outside
+    /// the unit circle if and only if all the reflection coefficients are in ]-1, 1[.
+    /// O(p^2), without computing the roots.
+    /// </summary>
+    class SchurCohn {
+    public:
+
+        /// <summary>
+        /// True if all the roots of p are outside the unit circle.
+        /// Stops at the first reflection coefficient out of ]-1, 1[
+        /// </summary>
+        static bool isStable(const Polynomial& p);
+
+        /// <summary>
+        /// Reflection coefficients of p in pacf[0, d[ (pacf[k-1] for the order k),
+        /// with d = p.getDegree(). Returns false if a coefficient is out of ]-1, 1[;
+        /// the recursion stops at that coefficient, the ones of the lower orders are NaN.
+        /// A polynomial with p[0] = 0 has a root at 0 (false, all the coefficients are NaN)
+        /// </summary>
+        static bool reflectionCoefficients(const Polynomial& p, double* pacf);
+
+        /// <summary>
+        /// Tests of count polynomials of degree d, with coefficients c[k*(d+1), (k+1)*(d+1)[.
+        /// stable[k] receives the result of polynomial k; when pacf is not null,
+        /// pacf[k*d, (k+1)*d[ receives its reflection coefficients. The parallel
+        /// policies split the polynomials in chunks on the thread pool
+        /// </summary>
+        template <class Policy>
+        static void isStable(const Policy& policy, const double* c, int d, int count, bool* stable, double* pacf = nullptr);
+
+    private:
+
+        // Step-down on phi[0, d[ (phi[j-1] = phij), destroyed; writes the coefficients in pacf if not null
+        static bool stepDown(double* phi, int d, double* pacf);
+
+        static bool test(const double* c, int d, double* pacf);
+    };
+
+    template <class Policy>
+    void SchurCohn::isStable(const Policy& policy, const double* c, int d, int count, bool* stable, double* pacf) {
+        static_assert(execution::is_execution_policy<Policy>::value, "execution policy expected");
+        auto fn = [c, d, stable, pacf](index_t k0, index_t k1) {
+            for (index_t k = k0; k < k1; ++k)
+                stable[k] = test(c + k * (d + 1), d, pacf ? pacf + k * d : nullptr);
+        };
+        // about PARALLEL_GRAIN operations by chunk
+        index_t grain = std::max<index_t>(1, Sequence<double>::PARALLEL_GRAIN / std::max(1, d * d));
+        if (execution::is_parallel(policy) && count > grain)
+            ThreadPool::instance().parallelFor(0, count, grain, fn);
+        else
+            fn(0, count);
+    }
+}
+
+#endif
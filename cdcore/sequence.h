@@ -8,7 +8,13 @@
 #include <stdexcept>
 #include <iterator>
 #include <cstddef>  
+#include "config.h"
 #include "constants.h"
+#include "random.h"
+#include "reductions.h"
+#include "copies.h"
+#include "scaling.h"
+#include "threadpool.h"
 
 namespace NUMCPP {
 
@@ -19,6 +25,9 @@ namespace NUMCPP {
     template <typename T>
     struct SequenceIterator;
 
+    template <class E>
+    struct Expression;
+
     /// <summary>
     /// Sequence of elements of type T that cannot be modified
     /// To be noted that the sequence itself can be modified (not its items)
@@ -35,7 +44,7 @@ namespace NUMCPP {
             using pointer = const T*;
             using reference = const T&;
 
-            ConstIterator(pointer ptr, int inc) :mPtr(ptr), mInc(inc) {}
+            ConstIterator(pointer ptr, index_t inc) :mPtr(ptr), mInc(inc) {}
 
             pointer operator->()const {
                 return mPtr;
@@ -69,7 +78,7 @@ namespace NUMCPP {
         private:
 
             pointer mPtr;
-            int mInc;
+            index_t mInc;
         };
 
 
@@ -82,7 +91,7 @@ namespace NUMCPP {
             using reference = T&;
 
 
-            Iterator(pointer ptr, int inc) :mPtr(ptr), mInc(inc) {}
+            Iterator(pointer ptr, index_t inc) :mPtr(ptr), mInc(inc) {}
 
             pointer operator->()const {
                 return mPtr;
@@ -116,7 +125,7 @@ namespace NUMCPP {
         private:
 
             pointer mPtr;
-            int mInc;
+            index_t mInc;
         };
 
 
@@ -124,16 +133,16 @@ namespace NUMCPP {
 
         }
 
-        Sequence(T* p0, T* p1, int inc) :m_data(p0), m_inc(inc) {
+        Sequence(T* p0, T* p1, index_t inc) :m_data(p0), m_inc(inc) {
             m_n = (p1 - p0) / inc;
         }
         Sequence(T* p0, T* p1) :m_data(p0), m_inc(1), m_n(p1 - p0) {
         }
 
-        Sequence(T* p0, int n, int inc) :m_data(p0), m_inc(inc), m_n(n) {
+        Sequence(T* p0, index_t n, index_t inc) :m_data(p0), m_inc(inc), m_n(n) {
         }
 
-        Sequence(T* p0, int n) :m_data(p0), m_inc(1), m_n(n) {
+        Sequence(T* p0, index_t n) :m_data(p0), m_inc(1), m_n(n) {
         }
 
         bool isEmpty() const {
@@ -156,29 +165,29 @@ namespace NUMCPP {
             return ConstIterator(m_data + m_inc * m_n, m_inc);
         }
 
-        Sequence<T> left(int n)const {
+        Sequence<T> left(index_t n)const {
             return Sequence<T>(m_data, n, m_inc);
         }
 
-        Sequence<T> right(int n)const {
+        Sequence<T> right(index_t n)const {
 
             return Sequence<T>(m_data + m_inc * (m_n - n), n, m_inc);
         }
 
-        Sequence<T> drop(int nl, int nr)const {
-            int nc = nl + nr;
+        Sequence<T> drop(index_t nl, index_t nr)const {
+            index_t nc = nl + nr;
             if (nc >= m_n)
                 return Sequence();
             return Sequence<T>(m_data + m_inc * nl, m_n - nc, m_inc);
         }
 
-        Sequence<T> extend(int nl, int nr)const {
+        Sequence<T> extend(index_t nl, index_t nr)const {
             return drop(-nl, -nr);
         }
 
-        Sequence<T> extract(int start, int n)const {
-            int nc = start + n;
-            if (nc >= m_n)
+        Sequence<T> extract(index_t start, index_t n)const {
+            index_t nc = start + n;
+            if (nc > m_n)
                 return Sequence();
             return Sequence<T>(m_data + m_inc * start, n, m_inc);
         }
@@ -187,21 +196,37 @@ namespace NUMCPP {
             return Sequence<T>(m_data + (m_n - 1) * m_inc, m_n, -m_inc);
         }
 
-        T& operator()(int idx)const {
+        T& operator()(index_t idx)const {
             return *(m_data + idx * m_inc);
         }
 
+        /// <summary>
+        /// this(i) = src(i). The sequences may overlap (see Copies::copy): contiguous
+        /// ones behave as through a temporary copy, strided ones are copied in order
+        /// </summary>
         void copy(Sequence<T> src)const;
 
         T dot(Sequence<T> src)const;
 
+        T dot(Sequence<T> src, Summation mode)const;
+
         void rand()const;
 
-        int length() const {
+        /// <summary>
+        /// Uniform ]0, 1[ fill; item i receives the output offset+i of rng
+        /// </summary>
+        void rand(const Philox& rng, uint64_t offset = 0)const;
+
+        /// <summary>
+        /// Standard normal fill; item i receives the output offset+i of rng
+        /// </summary>
+        void randn(const Philox& rng, uint64_t offset = 0)const;
+
+        index_t length() const {
             return m_n;
         }
 
-        int increment() const {
+        index_t increment() const {
             return m_inc;
         }
 
@@ -217,6 +242,10 @@ namespace NUMCPP {
 
         void mul(T value) const;
 
+        /// <summary>
+        /// Divides the items by value. When fast is true, the items are multiplied
+        /// by 1/value, provided that |value| >= safe_min (see Scaling::div)
+        /// </summary>
         void div(T value, bool fast = true) const;
 
         void add(T value)const;
@@ -241,6 +270,29 @@ namespace NUMCPP {
             return *this;
         }
 
+        const Sequence<T>& operator +=(Sequence<T> Y)const {
+            addAY(NUMCPP::CONSTANTS<T>::one, Y);
+            return *this;
+        }
+
+        const Sequence<T>& operator -=(Sequence<T> Y)const {
+            addAY(-NUMCPP::CONSTANTS<T>::one, Y);
+            return *this;
+        }
+
+        /// <summary>
+        /// Evaluates the lazy expression (see expressions.h) into the items of the sequence.
+        /// To be noted that the assignment of a sequence (x = y) still rebinds the view.
+        /// </summary>
+        template <class E>
+        const Sequence<T>& operator =(const Expression<E>& expr)const;
+
+        template <class E>
+        const Sequence<T>& operator +=(const Expression<E>& expr)const;
+
+        template <class E>
+        const Sequence<T>& operator -=(const Expression<E>& expr)const;
+
         void addAY(T a, Sequence<T> Y)const;
 
         void set(T value)const;
@@ -253,18 +305,42 @@ namespace NUMCPP {
 
         T ssq()const;
 
-        int imax()const;
+        /// <summary>
+        /// Sum computed following the given mode (see Summation)
+        /// </summary>
+        T sum(Summation mode)const;
+
+        T ssq(Summation mode)const;
+
+        /// <summary>
+        /// Position of the first maximum (-1 if the sequence is empty)
+        /// </summary>
+        index_t imax()const;
+
+        /// <summary>
+        /// Multi-threaded version of imax, for very long sequences
+        /// </summary>
+        index_t imax(int nthreads)const {
+            return Reductions<T>::imax(m_n, m_data, m_inc, nthreads);
+        }
 
         T max()const;
 
-        int imin()const;
+        /// <summary>
+        /// Position of the first minimum (-1 if the sequence is empty)
+        /// </summary>
+        index_t imin()const;
+
+        index_t imin(int nthreads)const {
+            return Reductions<T>::imin(m_n, m_data, m_inc, nthreads);
+        }
 
         T min()const;
 
         template <class Fn>
         T accumulate(Fn fn)const;
 
-        Sequence<T>& slide(int del);
+        Sequence<T>& slide(index_t del);
 
         Sequence<T>& bexpand() {
             m_data -= m_inc;
@@ -288,24 +364,24 @@ namespace NUMCPP {
             return *this;
         }
 
-        Sequence<T>& shrink(int nbeg, int nend) {
+        Sequence<T>& shrink(index_t nbeg, index_t nend) {
             m_data += m_inc * nbeg;
             m_n -= nbeg + nend;
             return *this;
         }
 
-        Sequence<T>& move(int n) {
+        Sequence<T>& move(index_t n) {
             m_data += m_inc * n;
             return *this;
         }
 
-        Sequence<T>& next(int n) {
+        Sequence<T>& next(index_t n) {
             m_data += m_inc * m_n;
             m_n = n;
             return *this;
         }
 
-        Sequence<T>& previous(int n) {
+        Sequence<T>& previous(index_t n) {
             m_data -= m_inc * n;
             m_n = n;
             return *this;
@@ -313,29 +389,44 @@ namespace NUMCPP {
 
         void swap(Sequence<T> other)const;
 
+        /// <summary>
+        /// x(i) = fn(x(i)) for all the items (strides are respected)
+        /// </summary>
         template <class Fn>
         void apply(Fn fn)const;
 
+        /// <summary>
+        /// Same as apply(fn), following the given execution policy (execution::seq, par, par_unseq).
+        /// With the parallel policies, fn may be called concurrently on different items.
+        /// </summary>
+        template <class Policy, class Fn, class = typename std::enable_if<execution::is_execution_policy<Policy>::value>::type>
+        void apply(const Policy& policy, Fn fn)const;
+
+        /// <summary>
+        /// Minimal number of items processed by a task in the parallel element-wise algorithms
+        /// </summary>
+        static const int PARALLEL_GRAIN = 1 << 14;
+
         template<typename S>
         friend std::ostream& operator<< (std::ostream& stream, Sequence<S> seq);
 
-        static void mul(int n, T value, T* x, int incx);
+        static void mul(index_t n, T value, T* x, index_t incx);
 
-        static void add(int n, T value, T* x, int incx);
+        static void add(index_t n, T value, T* x, index_t incx);
 
-        static void set(int n, T value, T* x, int incx);
+        static void set(index_t n, T value, T* x, index_t incx);
 
     private:
 
         T* m_data;
-        int m_inc;
-        int m_n;
+        index_t m_inc;
+        index_t m_n;
 
     };
 
 
     template <typename T>
-    inline Sequence<T>& Sequence<T>::slide(int del) {
+    inline Sequence<T>& Sequence<T>::slide(index_t del) {
         m_data += del;
         return *this;
     }
@@ -343,7 +434,7 @@ namespace NUMCPP {
     template <typename T>
     struct SequenceIterator {
 
-        SequenceIterator(const Sequence<T>& start, int niter, int inc)
+        SequenceIterator(const Sequence<T>& start, index_t niter, index_t inc)
             :m_data(start), m_end(niter), m_inc(inc), m_pos(0) {
         }
 
@@ -357,8 +448,8 @@ namespace NUMCPP {
             return m_data;
         }
 
-        void reset(int newpos) {
-            int del = m_pos - newpos;
+        void reset(index_t newpos) {
+            index_t del = m_pos - newpos;
             if (del != 0) {
                 del *= m_inc;
                 m_data.slide(-del);
@@ -370,14 +461,45 @@ namespace NUMCPP {
             reset(0);
         }
 
+        /// <summary>
+        /// Sequence returned by the (pos+1)-th call to next() after begin()
+        /// </summary>
+        Sequence<T> at(index_t pos)const {
+            Sequence<T> cur = m_data;
+            cur.slide((pos + 1 - m_pos) * m_inc);
+            return cur;
+        }
+
+        /// <summary>
+        /// Calls fn on each of the remaining sequences (the ones that next() would return),
+        /// using the shared thread pool. The iterator itself is not modified.
+        /// The calls should be independent (for instance different columns of a matrix).
+        /// </summary>
+        /// <param name="fn">Callable fn(Sequence<T>)</param>
+        /// <param name="grain">Minimal number of sequences processed by a task</param>
+        template <class Fn>
+        void parallelFor(Fn fn, index_t grain = 1)const;
+
     private:
 
         Sequence<T> m_data;
-        int m_end, m_inc, m_pos;
+        index_t m_end, m_inc, m_pos;
 
     };
 
 
+    template <typename T>
+    template <class Fn>
+    void SequenceIterator<T>::parallelFor(Fn fn, index_t grain)const {
+        ThreadPool::instance().parallelFor(m_pos, m_end, grain, [this, &fn](index_t i0, index_t i1) {
+            Sequence<T> cur = at(i0);
+            for (index_t i = i0; i < i1; ++i) {
+                fn(cur);
+                cur.slide(m_inc);
+            }
+            });
+    }
+
     template <typename T>
     class DataBlock
     {
@@ -388,16 +510,23 @@ namespace NUMCPP {
             m_size = 0;
         }
 
-        DataBlock(int n) {
+        DataBlock(index_t n) {
             m_data = new T[n];
             m_size = n;
         }
 
-        DataBlock(int n, T x);
+        DataBlock(index_t n, T x);
+
+        DataBlock(index_t n, T* px);
 
-        DataBlock(int n, T* px);
+        /// <summary>
+        /// Block initialized by fn(0), ..., fn(n-1)
+        /// </summary>
+        template <class Fn, class = typename std::enable_if<std::is_invocable_r<T, Fn, index_t>::value>::type>
+        DataBlock(index_t n, Fn fn);
 
-        DataBlock(int n, std::function<T(int)> fn);
+        template <class Policy, class Fn, class = typename std::enable_if<execution::is_execution_policy<Policy>::value>::type>
+        DataBlock(const Policy& policy, index_t n, Fn fn);
 
         DataBlock(const DataBlock<T>& x);
 
@@ -405,20 +534,40 @@ namespace NUMCPP {
 
         DataBlock<T>& operator=(const DataBlock<T>& x);
 
-        Sequence<T> all() {
+        DataBlock(DataBlock<T>&& x) noexcept :m_data(x.m_data), m_size(x.m_size) {
+            x.m_data = NULL;
+            x.m_size = 0;
+        }
+
+        DataBlock<T>& operator=(DataBlock<T>&& x) noexcept;
+
+        /// <summary>
+        /// Block initialized/overwritten by a lazy expression (see expressions.h)
+        /// </summary>
+        template <class E>
+        DataBlock(const Expression<E>& expr);
+
+        template <class E>
+        DataBlock<T>& operator=(const Expression<E>& expr);
+
+        Sequence<T> all()const {
             return Sequence<T>(m_data, m_size);
         }
 
-        int length() {
+        index_t length()const {
             return m_size;
         }
 
-        T& operator()(int idx) {
+        T& operator()(index_t idx) {
             return m_data[idx];
         }
 
         void rand();
 
+        void rand(const Philox& rng, uint64_t offset = 0);
+
+        void randn(const Philox& rng, uint64_t offset = 0);
+
         virtual ~DataBlock();
 
         template<typename S>
@@ -428,41 +577,60 @@ namespace NUMCPP {
     private:
 
         T* m_data;
-        int m_size;
+        index_t m_size;
     };
 
     template<typename T>
-    DataBlock<T>::DataBlock(int n, T* px) {
+    DataBlock<T>::DataBlock(index_t n, T* px) {
         m_data = new T[n];
         m_size = n;
-        for (int u = 0; u < m_size; ++u) {
+        for (index_t u = 0; u < m_size; ++u) {
             m_data[u] = px[u];
         }
     }
 
     template<typename T>
-    DataBlock<T>::DataBlock(int n, T x) {
+    DataBlock<T>::DataBlock(index_t n, T x) {
         m_data = new T[n];
         m_size = n;
-        for (int u = 0; u < m_size; ++u) {
+        for (index_t u = 0; u < m_size; ++u) {
             m_data[u] = x;
         }
     }
 
     template<typename T>
-    DataBlock<T>::DataBlock(int n, std::function<T(int)> fn) {
+    template <class Fn, class>
+    DataBlock<T>::DataBlock(index_t n, Fn fn) {
         m_data = new T[n];
         m_size = n;
-        for (int u = 0; u < m_size; ++u) {
+        for (index_t u = 0; u < m_size; ++u) {
             m_data[u] = fn(u);
         }
     }
 
+    template<typename T>
+    template <class Policy, class Fn, class>
+    DataBlock<T>::DataBlock(const Policy& policy, index_t n, Fn fn) {
+        m_data = new T[n];
+        m_size = n;
+        T* data = m_data;
+        if (execution::is_parallel(policy) && n > Sequence<T>::PARALLEL_GRAIN) {
+            ThreadPool::instance().parallelFor(0, n, Sequence<T>::PARALLEL_GRAIN, [data, &fn](index_t i0, index_t i1) {
+                for (index_t u = i0; u < i1; ++u)
+                    data[u] = fn(u);
+                });
+        }
+        else {
+            for (index_t u = 0; u < n; ++u)
+                data[u] = fn(u);
+        }
+    }
+
     template<typename T>
     DataBlock<T>::DataBlock(const DataBlock<T>& x) {
         m_data = new T[x.m_size];
         m_size = x.m_size;
-        for (int u = 0; u < m_size; ++u) {
+        for (index_t u = 0; u < m_size; ++u) {
             m_data[u] = x.m_data[u];
         }
     }
@@ -471,12 +639,7 @@ namespace NUMCPP {
     DataBlock<T>::DataBlock(const Sequence<T>& x) {
         m_size = x.length();
         m_data = new T[m_size];
-        auto cur = x.cbegin();
-        auto end = x.cend();
-        int i = 0;
-        while (cur != end) {
-            m_data[i] = *cur++;
-        }
+        x.copyTo(m_data);
     }
 
     template<typename T>
@@ -485,13 +648,25 @@ namespace NUMCPP {
             delete[] m_data;
             m_data = new T[x.m_size];
             m_size = x.m_size;
-            for (int u = 0; u < m_size; ++u) {
+            for (index_t u = 0; u < m_size; ++u) {
                 m_data[u] = x.m_data[u];
             }
         }
         return *this;
     }
 
+    template<typename T>
+    DataBlock<T>& DataBlock<T>::operator=(DataBlock<T>&& x) noexcept {
+        if (this != &x) {
+            delete[] m_data;
+            m_data = x.m_data;
+            m_size = x.m_size;
+            x.m_data = NULL;
+            x.m_size = 0;
+        }
+        return *this;
+    }
+
 
     template<typename T>
     DataBlock<T>::~DataBlock() {
@@ -501,46 +676,17 @@ namespace NUMCPP {
     template<typename T>
     inline void Sequence<T>::copy(Sequence<T> src)const
     {
-        if (m_n == 0)
-            return;
-        T* x = m_data;
-        T* y = src.m_data;
-        T* const e = x + m_inc * m_n;
-        int yinc = src.m_inc;
-        while (x != e) {
-            *x = *y;
-            y += yinc;
-            x += m_inc;
-        }
+        Copies<T>::copy(m_n, src.m_data, src.m_inc, m_data, m_inc);
     }
 
     template<typename T>
     inline void Sequence<T>::swap(Sequence<T> other)const {
-        if (m_n == 0)
-            return;
-        T* x = m_data;
-        T* y = other.m_data;
-        T* const e = x + m_inc * m_n;
-        int oinc = other.m_inc;
-        while (x != e) {
-            T tmp = *x;
-            *x = *y;
-            *y = tmp;
-            y += oinc;
-            x += m_inc;
-        }
+        Copies<T>::swap(m_n, m_data, m_inc, other.m_data, other.m_inc);
     }
 
     template<typename T>
-    void NUMCPP::Sequence<T>::copyTo(T* buffer) const {
-        if (m_n == 0)
-            return;
-        T* x = m_data;
-        T* const e = x + m_inc * m_n;
-        while (x != e) {
-            *buffer++ = *x;
-            x += m_inc;
-        }
+    inline void NUMCPP::Sequence<T>::copyTo(T* buffer) const {
+        Copies<T>::copy(m_n, m_data, m_inc, buffer, 1);
     }
 
 
@@ -550,16 +696,19 @@ namespace NUMCPP {
     }
 
 
+    template<>
+    inline void Sequence<double>::rand(const Philox& rng, uint64_t offset) const {
+        rng.uniform(offset, m_n, m_data, m_inc);
+    }
+
+    template<>
+    inline void Sequence<double>::randn(const Philox& rng, uint64_t offset) const {
+        rng.normal(offset, m_n, m_data, m_inc);
+    }
+
     template<>
     inline void Sequence<double>::rand() const {
-        std::random_device rd;
-        std::mt19937 mt(rd());
-        std::uniform_real_distribution<double> dist(0, 1);
-        double* x = m_data, * const e = x + m_inc * m_n;
-        while (e != x) {
-            *x = dist(mt);
-            x += m_inc;
-        }
+        rand(Philox::fromEntropy());
     }
 
     template<>
@@ -567,32 +716,24 @@ namespace NUMCPP {
         all().rand();
     }
 
+    template<>
+    inline void DataBlock<double>::rand(const Philox& rng, uint64_t offset) {
+        all().rand(rng, offset);
+    }
+
+    template<>
+    inline void DataBlock<double>::randn(const Philox& rng, uint64_t offset) {
+        all().randn(rng, offset);
+    }
+
     template<typename T>
-    void Sequence<T>::mul(int n, T value, T* x, int incx) {
-        if (value == NUMCPP::CONSTANTS<T>::one)
-            return;
-        if (value == NUMCPP::CONSTANTS<T>::zero) {
-            set(n, value, x, incx);
-            return;
-        }
-        int imax = incx * n;
-        for (int i = 0; i != imax; i += incx)
-            x[i] *= value;
+    inline void Sequence<T>::mul(index_t n, T value, T* x, index_t incx) {
+        Scaling<T>::scal(n, value, x, incx);
     }
 
     template<typename T>
-    void Sequence<T>::mul(T value)const {
-        if (value == NUMCPP::CONSTANTS<T>::one)
-            return;
-        if (value == NUMCPP::CONSTANTS<T>::zero) {
-            set(value);
-            return;
-        }
-        T* x = m_data, * const e = x + m_inc * m_n;
-        while (e != x) {
-            *x *= value;
-            x += m_inc;
-        }
+    inline void Sequence<T>::mul(T value)const {
+        Scaling<T>::scal(m_n, value, m_data, m_inc);
     }
 
     template<typename T>
@@ -607,25 +748,25 @@ namespace NUMCPP {
     }
 
     template<typename T>
-    void Sequence<T>::add(int n, T value, T* x, int incx) {
+    void Sequence<T>::add(index_t n, T value, T* x, index_t incx) {
         if (value == NUMCPP::CONSTANTS<T>::zero)
             return;
-        int imax = incx * n;
-        for (int i = 0; i != imax; i += incx)
+        index_t imax = incx * n;
+        for (index_t i = 0; i != imax; i += incx)
             x[i] += value;
     }
 
     template<typename T>
-    void Sequence<T>::set(int n, T value, T* x, int incx) {
-        int imax = incx * n;
-        for (int i = 0; i != imax; i += incx)
+    void Sequence<T>::set(index_t n, T value, T* x, index_t incx) {
+        index_t imax = incx * n;
+        for (index_t i = 0; i != imax; i += incx)
             x[i] = value;
     }
 
     template<typename T>
     void Sequence<T>::set(T value)const {
-        int imax = m_inc * m_n;
-        for (int i = 0; i != imax; i += m_inc)
+        index_t imax = m_inc * m_n;
+        for (index_t i = 0; i != imax; i += m_inc)
             m_data[i] = value;
     }
 
@@ -633,8 +774,8 @@ namespace NUMCPP {
     void Sequence<T>::addAY(T a, Sequence<T> Y) const {
         if (a == NUMCPP::CONSTANTS<T>::zero)
             return;
-        int imax = m_inc * m_n;
-        for (int i = 0, j = 0; i != imax; i += m_inc, j += Y.m_inc) {
+        index_t imax = m_inc * m_n;
+        for (index_t i = 0, j = 0; i != imax; i += m_inc, j += Y.m_inc) {
             m_data[i] += a * Y.m_data[j];
         }
     }
@@ -647,8 +788,8 @@ namespace NUMCPP {
     template<typename T>
     inline T Sequence<T>::sum()const {
         T s = NUMCPP::CONSTANTS<T>::zero;
-        int imax = m_inc * m_n;
-        for (int i = 0; i != imax; i += m_inc) {
+        index_t imax = m_inc * m_n;
+        for (index_t i = 0; i != imax; i += m_inc) {
             s += m_data[i];
         }
         return s;
@@ -657,8 +798,8 @@ namespace NUMCPP {
     template<typename T>
     T Sequence<T>::ssq()const {
         T s = NUMCPP::CONSTANTS<T>::zero;
-        int imax = m_inc * m_n;
-        for (int i = 0; i != imax; i += m_inc) {
+        index_t imax = m_inc * m_n;
+        for (index_t i = 0; i != imax; i += m_inc) {
             T cur = m_data[i];
             s += cur * cur;
         }
@@ -677,11 +818,38 @@ namespace NUMCPP {
         return s;
     }
 
+    template<typename T>
+    T Sequence<T>::sum(Summation mode)const {
+        if (mode == Summation::Reproducible)
+            return Reductions<T>::rsum(m_n, m_data, m_inc);
+        if (mode == Summation::Compensated)
+            return Reductions<T>::csum(m_n, m_data, m_inc);
+        return sum();
+    }
+
+    template<typename T>
+    T Sequence<T>::ssq(Summation mode)const {
+        if (mode == Summation::Reproducible)
+            return Reductions<T>::rssq(m_n, m_data, m_inc);
+        if (mode == Summation::Compensated)
+            return Reductions<T>::cssq(m_n, m_data, m_inc);
+        return ssq();
+    }
+
+    template<typename T>
+    T Sequence<T>::dot(Sequence<T> Y, Summation mode)const {
+        if (mode == Summation::Reproducible)
+            return Reductions<T>::rdot(m_n, m_data, m_inc, Y.m_data, Y.m_inc);
+        if (mode == Summation::Compensated)
+            return Reductions<T>::cdot(m_n, m_data, m_inc, Y.m_data, Y.m_inc);
+        return dot(Y);
+    }
+
     template<typename T>
     template<class Fn>
     T Sequence<T>::accumulate(Fn fn) const {
         T s = NUMCPP::CONSTANTS<T>::zero;
-        int incx = m_inc;
+        index_t incx = m_inc;
         T* x = m_data, * const e = x + incx * m_n;
         while (e != x) {
             s = fn(s, *x);
@@ -691,60 +859,49 @@ namespace NUMCPP {
     }
 
     template<typename T>
-    void Sequence<T>::div(T value, bool fast)const {
-        T one = NUMCPP::CONSTANTS<T>::one;
-        if (one == value)
-            return;
-        int incx = m_inc;
-        T* x = m_data, * const e = x + incx * m_n;
-        if (fast) {
-            T inv = one / value;
-            while (e != x) {
-                *x *= inv;
-                x += incx;
-            }
-        }
-        else
-            while (e != x) {
-                *x /= value;
-                x += incx;
-            }
+    inline void Sequence<T>::div(T value, bool fast)const {
+        Scaling<T>::div(m_n, value, m_data, m_inc, !fast);
     }
 
     template<typename T>
     template<class Fn>
     void Sequence<T>::apply(Fn fn)const {
-        int imax = m_inc * m_n;
-        for (int i = 0; i != imax; i += m_inc) {
-            m_data[i] = fn(m_data[i]);
+        T* x = m_data;
+        index_t n = m_n, inc = m_inc;
+        if (inc == 1) {
+            for (index_t i = 0; i < n; ++i)
+                x[i] = fn(x[i]);
+        }
+        else {
+            for (index_t i = 0; i < n; ++i)
+                x[i * inc] = fn(x[i * inc]);
+        }
+    }
+
+    template<typename T>
+    template <class Policy, class Fn, class>
+    void Sequence<T>::apply(const Policy& policy, Fn fn)const {
+        if (!execution::is_parallel(policy) || m_n <= PARALLEL_GRAIN) {
+            apply(fn);
+            return;
         }
+        Sequence<T> all = *this;
+        ThreadPool::instance().parallelFor(0, m_n, PARALLEL_GRAIN, [all, &fn](index_t i0, index_t i1) {
+            all.extract(i0, i1 - i0).apply(fn);
+            });
     }
 
     template<typename T>
     void Sequence<T>::chs() const {
-        int imax = m_inc * m_n;
-        for (int i = 0; i != imax; i += m_inc) {
+        index_t imax = m_inc * m_n;
+        for (index_t i = 0; i != imax; i += m_inc) {
             m_data[i] = -m_data[i];
         }
     }
 
     template<typename T>
-    int Sequence<T>::imax() const {
-        if (isEmpty())
-            return -1;
-        if (m_n == 1)
-            return 0;
-        int nmax = m_inc * m_n;
-        T cmax = m_data[0];
-        int imax = 0;
-        for (int i = 1; i != nmax; i += m_inc) {
-            T cur = m_data[i];
-            if (cur > cmax) {
-                cmax = cur;
-                imax = i;
-            }
-        }
-        return imax;
+    inline index_t Sequence<T>::imax() const {
+        return Reductions<T>::imax(m_n, m_data, m_inc);
     }
 
     template<typename T>
@@ -753,9 +910,9 @@ namespace NUMCPP {
             return NUMCPP::CONSTANTS<T>::zero;
         if (m_n == 1)
             return m_data[0];
-        int nmax = m_inc * m_n;
+        index_t nmax = m_inc * m_n;
         T cmax = m_data[0];
-        for (int i = 1; i != nmax; i += m_inc) {
+        for (index_t i = 1; i != nmax; i += m_inc) {
             T cur = m_data[i];
             if (cur > cmax) {
                 cmax = cur;
@@ -765,22 +922,8 @@ namespace NUMCPP {
     }
 
     template<typename T>
-    int Sequence<T>::imin() const {
-        if (isEmpty())
-            return -1;
-        if (m_n == 1)
-            return 0;
-        int nmax = m_inc * m_n;
-        T cmin = m_data[0];
-        int imin = 0;
-        for (int i = 1; i != nmax; i += m_inc) {
-            T cur = m_data[i];
-            if (cur > cmin) {
-                cmin = cur;
-                imin = i;
-            }
-        }
-        return imin;
+    inline index_t Sequence<T>::imin() const {
+        return Reductions<T>::imin(m_n, m_data, m_inc);
     }
 
     template<typename T>
@@ -789,9 +932,9 @@ namespace NUMCPP {
             return NUMCPP::CONSTANTS<T>::zero;
         if (m_n == 1)
             return m_data[0];
-        int nmax = m_inc * m_n;
+        index_t nmax = m_inc * m_n;
         T cmin = m_data[0];
-        for (int i = 1; i != nmax; i += m_inc) {
+        for (index_t i = 1; i != nmax; i += m_inc) {
             T cur = m_data[i];
             if (cur < cmin) {
                 cmin = cur;
@@ -813,4 +956,7 @@ namespace NUMCPP {
 
 
 }
+
+#include "expressions.h"
+
 #endif
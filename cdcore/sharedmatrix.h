@@ -0,0 +1,158 @@
+#ifndef __numcpp_sharedmatrix_h
+#define __numcpp_sharedmatrix_h
+
+#include <climits>
+#include <stdexcept>
+#include "matrix.h"
+#include "rdvector.h"
+
+namespace NUMCPP {
+
+	/// <summary>
+	/// Column-major matrix with copy-on-write storage (_svector).
+	/// Copies share the items until one of them is modified: the non-const accessors
+	/// (operator(), all(), row(), column()) first copy the items if they are shared.
+	/// The const accessors never copy; the views they return must only be read.
+	/// A view obtained before a copy of the matrix should not be used to modify it
+	/// once the matrix is shared. The number of items is limited to INT_MAX.
+	/// </summary>
+	/// <typeparam name="T"></typeparam>
+	template<typename T>
+	class SharedMatrix
+	{
+	public:
+
+		SharedMatrix() :m_nrows(0), m_ncols(0) {}
+
+		SharedMatrix(index_t nrows, index_t ncols);
+
+		template<class Fn>
+		SharedMatrix(index_t nrows, index_t ncols, Fn fn);
+
+		/// <summary>
+		/// Copy of the items of M
+		/// </summary>
+		explicit SharedMatrix(const FastMatrix<T>& M);
+
+		explicit SharedMatrix(const Matrix<T>& M) :SharedMatrix(M.all()) {}
+
+		index_t getNrows()const {
+			return m_nrows;
+		}
+
+		index_t getNcols()const {
+			return m_ncols;
+		}
+
+		index_t size()const {
+			return m_nrows * m_ncols;
+		}
+
+		/// <summary>
+		/// True if the items are shared with other matrices
+		/// </summary>
+		bool isShared()const {
+			return m_data.refCount() > 1;
+		}
+
+		T operator()(index_t r, index_t c)const {
+			return m_data.getCPtr()[r + m_nrows * c];
+		}
+
+		T& operator()(index_t r, index_t c) {
+			return m_data.getPtr()[r + m_nrows * c];
+		}
+
+		FastMatrix<T> all();
+
+		const FastMatrix<T> all()const;
+
+		Sequence<T> row(index_t row) {
+			return all().row(row);
+		}
+
+		Sequence<T> column(index_t col) {
+			return all().column(col);
+		}
+
+		const Sequence<T> row(index_t row)const {
+			return all().row(row);
+		}
+
+		const Sequence<T> column(index_t col)const {
+			return all().column(col);
+		}
+
+		/// <summary>
+		/// Deep copy in a standard matrix
+		/// </summary>
+		Matrix<T> toMatrix()const;
+
+		template<typename S>
+		friend std::ostream& operator<< (std::ostream& stream, const SharedMatrix<S>& matrix);
+
+	private:
+
+		// _svector is indexed by int: larger matrices are rejected in all the builds
+		static int length(index_t nrows, index_t ncols) {
+			long long n = static_cast<long long>(nrows) * static_cast<long long>(ncols);
+			if (nrows < 0 || ncols < 0 || n > INT_MAX)
+				throw std::length_error("SharedMatrix: more than INT_MAX items");
+			return static_cast<int>(n);
+		}
+
+		_svector<T> m_data;
+		index_t m_nrows, m_ncols;
+	};
+
+	template<typename T>
+	SharedMatrix<T>::SharedMatrix(index_t nrows, index_t ncols)
+		:m_data(length(nrows, ncols)), m_nrows(nrows), m_ncols(ncols)
+	{
+	}
+
+	template<typename T>
+	template<class Fn>
+	SharedMatrix<T>::SharedMatrix(index_t nrows, index_t ncols, Fn op)
+		: m_data(length(nrows, ncols)), m_nrows(nrows), m_ncols(ncols)
+	{
+		T* data = m_data.getPtr();
+		for (index_t c = 0, j = 0; c < ncols; ++c) {
+			for (index_t r = 0; r < nrows; ++r, ++j)
+				data[j] = op(r, c);
+		}
+	}
+
+	template<typename T>
+	SharedMatrix<T>::SharedMatrix(const FastMatrix<T>& M)
+		: m_data(length(M.getNrows(), M.getNcols())), m_nrows(M.getNrows()), m_ncols(M.getNcols())
+	{
+		T* data = m_data.getPtr();
+		for (index_t c = 0; c < m_ncols; ++c, data += m_nrows)
+			M.column(c).copyTo(data);
+	}
+
+	template<typename T>
+	inline FastMatrix<T> SharedMatrix<T>::all() {
+		return FastMatrix<T>(m_data.getPtr(), m_nrows, m_nrows, m_ncols);
+	}
+
+	template<typename T>
+	inline const FastMatrix<T> SharedMatrix<T>::all()const {
+		return FastMatrix<T>(const_cast<T*>(m_data.getCPtr()), m_nrows, m_nrows, m_ncols);
+	}
+
+	template<typename T>
+	Matrix<T> SharedMatrix<T>::toMatrix()const {
+		Matrix<T> M(m_nrows, m_ncols);
+		Copies<T>::copy(size(), m_data.getCPtr(), 1, &M(0, 0), 1);
+		return M;
+	}
+
+	template<typename T>
+	std::ostream& operator<< (std::ostream& stream, const SharedMatrix<T>& matrix) {
+		return stream << matrix.all();
+	}
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef __numcpp_smallblock_h
+#define __numcpp_smallblock_h
+
+#include <new>
+#include <cstring>
+#include <type_traits>
+#include "config.h"
+#include "sequence.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Block of items with inline storage for up to N items (small-buffer optimization).
+    /// Short blocks (typically polynomial coefficients) live in the object itself;
+    /// longer blocks are allocated on the heap, aligned on NUMCPP_ALIGNMENT bytes.
+    /// The block is move-only: returning it from a function never allocates, and
+    /// an explicit copy is made through SmallBlock(const Sequence&).
+    /// </summary>
+    /// <typeparam name="T">Trivially copyable type</typeparam>
+    /// <typeparam name="N">Number of inline items</typeparam>
+    template <typename T, int N = NUMCPP_SMALLBLOCK_SIZE>
+    class SmallBlock
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SmallBlock requires trivially copyable items");
+        static_assert(N > 0, "SmallBlock requires inline storage");
+
+    public:
+
+        static const int INLINE_SIZE = N;
+
+        SmallBlock() :m_data(m_local), m_size(0) {}
+
+        explicit SmallBlock(index_t n) :m_data(allocate(n)), m_size(n) {}
+
+        SmallBlock(index_t n, T x);
+
+        SmallBlock(const Sequence<T>& x);
+
+        SmallBlock(SmallBlock&& x) noexcept;
+
+        SmallBlock& operator=(SmallBlock&& x) noexcept;
+
+        SmallBlock(const SmallBlock&) = delete;
+        SmallBlock& operator=(const SmallBlock&) = delete;
+
+        ~SmallBlock() {
+            release();
+        }
+
+        Sequence<T> all()const {
+            return Sequence<T>(m_data, m_size);
+        }
+
+        index_t length()const {
+            return m_size;
+        }
+
+        T& operator()(index_t idx) {
+            return m_data[idx];
+        }
+
+        T operator()(index_t idx)const {
+            return m_data[idx];
+        }
+
+        T* data() {
+            return m_data;
+        }
+
+        const T* data()const {
+            return m_data;
+        }
+
+        /// <summary>
+        /// True if the items are stored in the object itself
+        /// </summary>
+        bool isInline()const {
+            return m_data == m_local;
+        }
+
+        template<typename S, int M>
+        friend std::ostream& operator<< (std::ostream& stream, const SmallBlock<S, M>& block);
+
+    private:
+
+        T* allocate(index_t n) {
+            if (n <= N)
+                return m_local;
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(NUMCPP_ALIGNMENT)));
+        }
+
+        void release() {
+            if (m_data != m_local)
+                ::operator delete(m_data, std::align_val_t(NUMCPP_ALIGNMENT));
+        }
+
+        void steal(SmallBlock& x) {
+            if (x.m_data == x.m_local) {
+                m_data = m_local;
+                std::memcpy(static_cast<void*>(m_local), static_cast<const void*>(x.m_local), x.m_size * sizeof(T));
+            }
+            else {
+                m_data = x.m_data;
+                x.m_data = x.m_local;
+            }
+            m_size = x.m_size;
+            x.m_size = 0;
+        }
+
+        T* m_data;
+        index_t m_size;
+        T m_local[N];
+    };
+
+    template <typename T, int N>
+    SmallBlock<T, N>::SmallBlock(index_t n, T x) :m_data(allocate(n)), m_size(n) {
+        for (index_t u = 0; u < m_size; ++u)
+            m_data[u] = x;
+    }
+
+    template <typename T, int N>
+    SmallBlock<T, N>::SmallBlock(const Sequence<T>& x) :m_data(allocate(x.length())), m_size(x.length()) {
+        x.copyTo(m_data);
+    }
+
+    template <typename T, int N>
+    SmallBlock<T, N>::SmallBlock(SmallBlock&& x) noexcept {
+        steal(x);
+    }
+
+    template <typename T, int N>
+    SmallBlock<T, N>& SmallBlock<T, N>::operator=(SmallBlock&& x) noexcept {
+        if (this != &x) {
+            release();
+            steal(x);
+        }
+        return *this;
+    }
+
+    template <typename T, int N>
+    std::ostream& operator<< (std::ostream& stream, const SmallBlock<T, N>& block) {
+        return stream << block.all();
+    }
+
+    namespace EXPR {
+
+        template <typename T, int N>
+        struct Node<SmallBlock<T, N>> {
+            static const bool valid = true;
+            typedef T value_type;
+            typedef Leaf<T> type;
+            static type make(const SmallBlock<T, N>& s) { return type(s.data(), s.length(), 1); }
+        };
+    }
+}
+
+#endif
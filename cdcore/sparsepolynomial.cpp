@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include "sparsepolynomial.h"
+
+using namespace NUMCPP;
+
+namespace {
+
+	// x^n, n >= 0, by binary powering
+	template <class T>
+	T ipow(T x, int n) {
+		T r = 1;
+		while (n > 0) {
+			if (n & 1)
+				r *= x;
+			x *= x;
+			n >>= 1;
+		}
+		return r;
+	}
+
+	// sum c[k] x^lag[k], with the powers computed incrementally on the (sorted) lags
+	template <class T>
+	T evaluate(const std::vector<int>& lags, const std::vector<double>& c, const T& x) {
+		T s = 0, xp = 1;
+		int cur = 0;
+		for (size_t k = 0; k < lags.size(); ++k) {
+			xp *= ipow(x, lags[k] - cur);
+			cur = lags[k];
+			s += c[k] * xp;
+		}
+		return s;
+	}
+}
+
+SparsePolynomial::SparsePolynomial(int n, const int* lags, const double* c) :m_lags(lags, lags + n), m_c(c, c + n) {
+	normalize();
+}
+
+SparsePolynomial::SparsePolynomial(const Polynomial& p) {
+	int d = p.getDegree();
+	for (int i = 0; i <= d; ++i) {
+		if (p[i] != 0) {
+			m_lags.push_back(i);
+			m_c.push_back(p[i]);
+		}
+	}
+}
+
+void SparsePolynomial::normalize() {
+	int n = (int)m_lags.size();
+	bool sorted = true;
+	for (int i = 1; i < n && sorted; ++i)
+		sorted = m_lags[i - 1] < m_lags[i];
+	if (!sorted) {
+		std::vector<std::pair<int, double>> items(n);
+		for (int i = 0; i < n; ++i)
+			items[i] = std::make_pair(m_lags[i], m_c[i]);
+		std::sort(items.begin(), items.end(),
+			[](const std::pair<int, double>& a, const std::pair<int, double>& b) {return a.first < b.first; });
+		for (int i = 0; i < n; ++i) {
+			m_lags[i] = items[i].first;
+			m_c[i] = items[i].second;
+		}
+	}
+	// merges the repeated lags and removes the zeros
+	int j = 0;
+	for (int i = 0; i < n;) {
+		int lag = m_lags[i];
+		double c = 0;
+		for (; i < n && m_lags[i] == lag; ++i)
+			c += m_c[i];
+		if (c != 0) {
+			m_lags[j] = lag;
+			m_c[j++] = c;
+		}
+	}
+	m_lags.resize(j);
+	m_c.resize(j);
+}
+
+Polynomial SparsePolynomial::toPolynomial()const {
+	if (m_lags.empty())
+		return Polynomial::ZERO;
+	int d = getDegree();
+	std::vector<double> c(d + 1, 0.0);
+	for (size_t k = 0; k < m_lags.size(); ++k)
+		c[m_lags[k]] = m_c[k];
+	return Polynomial(d, c.data());
+}
+
+double SparsePolynomial::operator[](int lag)const {
+	auto it = std::lower_bound(m_lags.begin(), m_lags.end(), lag);
+	if (it == m_lags.end() || *it != lag)
+		return 0;
+	return m_c[it - m_lags.begin()];
+}
+
+SparsePolynomial SparsePolynomial::operator*(const SparsePolynomial& r)const {
+	SparsePolynomial result;
+	size_t nl = m_lags.size(), nr = r.m_lags.size();
+	result.m_lags.reserve(nl * nr);
+	result.m_c.reserve(nl * nr);
+	for (size_t i = 0; i < nl; ++i) {
+		for (size_t j = 0; j < nr; ++j) {
+			result.m_lags.push_back(m_lags[i] + r.m_lags[j]);
+			result.m_c.push_back(m_c[i] * r.m_c[j]);
+		}
+	}
+	result.normalize();
+	return result;
+}
+
+Polynomial SparsePolynomial::operator*(const Polynomial& r)const {
+	if (!r.isValid())
+		return Polynomial();
+	if (m_lags.empty())
+		return Polynomial::ZERO;
+	int nr = r.getDegree() + 1;
+	int d = getDegree() + nr - 1;
+	std::vector<double> out(d + 1, 0.0);
+	for (size_t k = 0; k < m_lags.size(); ++k) {
+		double c = m_c[k];
+		double* o = out.data() + m_lags[k];
+		for (int j = 0; j < nr; ++j)
+			o[j] += c * r[j];
+	}
+	return Polynomial(d, out.data());
+}
+
+SparsePolynomial SparsePolynomial::operator+(const SparsePolynomial& r)const {
+	SparsePolynomial result(*this);
+	result.m_lags.insert(result.m_lags.end(), r.m_lags.begin(), r.m_lags.end());
+	result.m_c.insert(result.m_c.end(), r.m_c.begin(), r.m_c.end());
+	result.normalize();
+	return result;
+}
+
+SparsePolynomial SparsePolynomial::operator-(const SparsePolynomial& r)const {
+	return *this + r * -1.0;
+}
+
+SparsePolynomial SparsePolynomial::operator*(double a)const {
+	if (a == 0)
+		return SparsePolynomial();
+	SparsePolynomial result(*this);
+	for (double& c : result.m_c)
+		c *= a;
+	return result;
+}
+
+double SparsePolynomial::evaluateAt(double x)const {
+	return evaluate(m_lags, m_c, x);
+}
+
+std::complex<double> SparsePolynomial::evaluateAt(const std::complex<double>& x)const {
+	return evaluate(m_lags, m_c, x);
+}
+
+std::complex<double> SparsePolynomial::evaluateAtFrequency(double w)const {
+	std::complex<double> f = 0;
+	for (size_t k = 0; k < m_lags.size(); ++k)
+		f += std::polar(m_c[k], w * m_lags[k]);
+	return f;
+}
+
+void SparsePolynomial::filter(const double* x, int n, double* y)const {
+	int nnz = (int)m_lags.size();
+	const int* lags = m_lags.data();
+	const double* c = m_c.data();
+	int d = std::min(getDegree(), n);
+	// start: only the lags <= t
+	for (int t = 0; t < d; ++t) {
+		double s = 0;
+		for (int k = 0; k < nnz && lags[k] <= t; ++k)
+			s += c[k] * x[t - lags[k]];
+		y[t] = s;
+	}
+	for (int t = d; t < n; ++t) {
+		double s = 0;
+		for (int k = 0; k < nnz; ++k)
+			s += c[k] * x[t - lags[k]];
+		y[t] = s;
+	}
+}
+
+void SparsePolynomial::inverseFilter(const double* x, int n, double* y)const {
+	assert(!m_lags.empty() && m_lags[0] == 0);
+	int nnz = (int)m_lags.size();
+	const int* lags = m_lags.data();
+	const double* c = m_c.data();
+	double c0 = c[0];
+	int d = std::min(getDegree(), n);
+	for (int t = 0; t < d; ++t) {
+		double s = x[t];
+		for (int k = 1; k < nnz && lags[k] <= t; ++k)
+			s -= c[k] * y[t - lags[k]];
+		y[t] = s / c0;
+	}
+	for (int t = d; t < n; ++t) {
+		double s = x[t];
+		for (int k = 1; k < nnz; ++k)
+			s -= c[k] * y[t - lags[k]];
+		y[t] = s / c0;
+	}
+}
@@ -0,0 +1,102 @@
+#ifndef __numcpp_sparsepolynomial_h
+#define __numcpp_sparsepolynomial_h
+
+#include <complex>
+#include <vector>
+#include "polynomials.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Real polynomial stored as (lag, coefficient) pairs: sum c[k] x^lag[k].
+    /// Intended for seasonal lag operators such as 1 - th B^12 - TH B^24, where most
+    /// of the coefficients are zero. The pairs are sorted by increasing lags, without
+    /// zero coefficients; the zero polynomial has no pair (and degree 0).
+    /// </summary>
+    class SparsePolynomial {
+    public:
+
+        SparsePolynomial() {}
+
+        /// <summary>
+        /// sum c[i] x^lags[i], i in [0, n[. The lags (>= 0) may be in any order;
+        /// the coefficients of repeated lags are added
+        /// </summary>
+        SparsePolynomial(int n, const int* lags, const double* c);
+
+        /// <summary>
+        /// Non-zero coefficients of p
+        /// </summary>
+        explicit SparsePolynomial(const Polynomial& p);
+
+        /// <summary>
+        /// Dense equivalent
+        /// </summary>
+        Polynomial toPolynomial()const;
+
+        int getDegree()const {
+            return m_lags.empty() ? 0 : m_lags.back();
+        }
+
+        /// <summary>
+        /// Number of (lag, coefficient) pairs
+        /// </summary>
+        int getNonZerosCount()const {
+            return (int)m_lags.size();
+        }
+
+        int lag(int i)const {
+            return m_lags[i];
+        }
+
+        double coefficient(int i)const {
+            return m_c[i];
+        }
+
+        /// <summary>
+        /// Coefficient of x^lag (binary search)
+        /// </summary>
+        double operator[](int lag)const;
+
+        /// <summary>
+        /// Products in O(nnz(l) * nnz(r) log) for two sparse polynomials and
+        /// in O(nnz * (degree(r)+1)) for a dense operand
+        /// </summary>
+        SparsePolynomial operator*(const SparsePolynomial& r)const;
+        Polynomial operator*(const Polynomial& r)const;
+        SparsePolynomial operator+(const SparsePolynomial& r)const;
+        SparsePolynomial operator-(const SparsePolynomial& r)const;
+        SparsePolynomial operator*(double a)const;
+
+        double evaluateAt(double x)const;
+        std::complex<double> evaluateAt(const std::complex<double>& x)const;
+        std::complex<double> evaluateAtFrequency(double w)const;
+
+        /// <summary>
+        /// y[t] = sum c[k] x[t-lag[k]], t in [0, n[; the values before x[0] are 0.
+        /// O(nnz) per point. y must not overlap x
+        /// </summary>
+        void filter(const double* x, int n, double* y)const;
+
+        /// <summary>
+        /// Solution of the recursion sum c[k] y[t-lag[k]] = x[t], t in [0, n[, with
+        /// y[t] = 0 for t < 0 (y = x / P). The polynomial must have a non-zero constant.
+        /// O(nnz) per point. y may be x
+        /// </summary>
+        void inverseFilter(const double* x, int n, double* y)const;
+
+    private:
+
+        // sorts the pairs by lags, merges the repeated lags and removes the zeros
+        void normalize();
+
+        std::vector<int> m_lags;
+        std::vector<double> m_c;
+    };
+
+    inline Polynomial operator*(const Polynomial& l, const SparsePolynomial& r) {
+        return r * l;
+    }
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include <chrono>
+#include "threadpool.h"
+
+using namespace NUMCPP;
+
+namespace {
+	// Identifies the pool worker running on the current thread
+	thread_local const ThreadPool* t_pool = nullptr;
+	thread_local int t_worker = -1;
+}
+
+ThreadPool& ThreadPool::instance() {
+	static ThreadPool pool(std::max(1, static_cast<int>(std::thread::hardware_concurrency())) - 1);
+	return pool;
+}
+
+ThreadPool::ThreadPool(int nworkers) :m_queued(0), m_next(0), m_stop(false) {
+	for (int i = 0; i < nworkers; ++i)
+		m_queues.emplace_back(new Queue());
+	for (int i = 0; i < nworkers; ++i)
+		m_workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wakeup.notify_all();
+	for (auto& t : m_workers)
+		t.join();
+}
+
+void ThreadPool::run(int ntasks, const std::function<void(int)>& fn) {
+	if (ntasks <= 0)
+		return;
+	if (ntasks == 1 || m_workers.empty()) {
+		for (int i = 0; i < ntasks; ++i)
+			fn(i);
+		return;
+	}
+	Group group(ntasks, fn);
+	int id = t_pool == this ? t_worker : -1;
+	int nq = static_cast<int>(m_queues.size());
+	// Task 0 is kept by the calling thread; the other ones are dealt to the workers,
+	// starting with the own queue of the caller when it is a worker
+	unsigned start = id >= 0 ? id : m_next.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queued += ntasks - 1;
+	}
+	for (int i = 1; i < ntasks; ++i) {
+		Queue& q = *m_queues[(start + i - 1) % nq];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		q.tasks.push_back(Task{ &group, i });
+	}
+	m_wakeup.notify_all();
+	execute(Task{ &group, 0 });
+	// Helps the pool until the job is completed
+	while (group.pending.load(std::memory_order_acquire) > 0) {
+		Task task;
+		if ((id >= 0 && pop(id, task)) || steal(id, task)) {
+			execute(task);
+		}
+		else {
+			std::unique_lock<std::mutex> lock(group.mutex);
+			group.done.wait_for(lock, std::chrono::milliseconds(1),
+				[&group]() {return group.pending.load(std::memory_order_acquire) == 0; });
+		}
+	}
+	// The last task may still hold the lock of the group
+	std::lock_guard<std::mutex> lock(group.mutex);
+	if (group.error)
+		std::rethrow_exception(group.error);
+}
+
+void ThreadPool::work(int id) {
+	t_pool = this;
+	t_worker = id;
+	while (true) {
+		Task task;
+		if (pop(id, task) || steal(id, task)) {
+			execute(task);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_wakeup.wait(lock, [this]() {return m_stop || m_queued.load() > 0; });
+		if (m_stop)
+			return;
+	}
+}
+
+bool ThreadPool::pop(int id, Task& task) {
+	Queue& q = *m_queues[id];
+	std::lock_guard<std::mutex> lock(q.mutex);
+	if (q.tasks.empty())
+		return false;
+	task = q.tasks.back();
+	q.tasks.pop_back();
+	--m_queued;
+	return true;
+}
+
+bool ThreadPool::steal(int id, Task& task) {
+	int nq = static_cast<int>(m_queues.size());
+	int first = id >= 0 ? id + 1 : 0;
+	for (int i = 0; i < nq; ++i) {
+		int k = (first + i) % nq;
+		if (k == id)
+			continue;
+		Queue& q = *m_queues[k];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (!q.tasks.empty()) {
+			task = q.tasks.front();
+			q.tasks.pop_front();
+			--m_queued;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::execute(const Task& task) {
+	Group& group = *task.group;
+	try {
+		group.fn(task.index);
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(group.mutex);
+		if (!group.error)
+			group.error = std::current_exception();
+	}
+	std::lock_guard<std::mutex> lock(group.mutex);
+	if (group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		group.done.notify_all();
+}
@@ -0,0 +1,150 @@
+#ifndef __numcpp_threadpool_h
+#define __numcpp_threadpool_h
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <algorithm>
+#include <type_traits>
+#include "config.h"
+
+namespace NUMCPP {
+
+    /// <summary>
+    /// Execution policies of the element-wise algorithms (same meaning as in std::execution):
+    /// seq: serial loop; par: chunks processed on the shared thread pool;
+    /// par_unseq: chunks on the thread pool, items of a chunk in any order (SIMD)
+    /// </summary>
+    namespace execution {
+
+        struct sequenced_policy {};
+        struct parallel_policy {};
+        struct parallel_unsequenced_policy {};
+
+        constexpr sequenced_policy seq{};
+        constexpr parallel_policy par{};
+        constexpr parallel_unsequenced_policy par_unseq{};
+
+        template <class P>
+        struct is_execution_policy : std::false_type {};
+
+        template <>
+        struct is_execution_policy<sequenced_policy> : std::true_type {};
+
+        template <>
+        struct is_execution_policy<parallel_policy> : std::true_type {};
+
+        template <>
+        struct is_execution_policy<parallel_unsequenced_policy> : std::true_type {};
+
+        template <class P>
+        constexpr bool is_parallel(const P&) {
+            return !std::is_same<P, sequenced_policy>::value;
+        }
+    }
+
+    /// <summary>
+    /// Work-stealing thread pool shared by the cdcore kernels.
+    /// Each worker owns a deque of tasks; it takes its own tasks from the back and,
+    /// when idle, steals the oldest tasks of the other workers. The thread that submits
+    /// a job takes part in its execution, so that nested parallel calls cannot deadlock.
+    /// </summary>
+    class ThreadPool {
+    public:
+
+        /// <summary>
+        /// Pool shared by all the library (hardware_concurrency - 1 workers)
+        /// </summary>
+        static ThreadPool& instance();
+
+        explicit ThreadPool(int nworkers);
+
+        ~ThreadPool();
+
+        /// <summary>
+        /// Number of threads that may execute a job (workers + calling thread)
+        /// </summary>
+        int concurrency()const {
+            return static_cast<int>(m_workers.size()) + 1;
+        }
+
+        /// <summary>
+        /// Executes fn(0), ..., fn(ntasks-1) and waits for their completion.
+        /// The first exception thrown by a task is rethrown in the calling thread.
+        /// </summary>
+        void run(int ntasks, const std::function<void(int)>& fn);
+
+        /// <summary>
+        /// Splits [begin, end[ in contiguous chunks of at least grain items
+        /// and calls fn(i0, i1) on each of them
+        /// </summary>
+        template <class Fn>
+        void parallelFor(index_t begin, index_t end, index_t grain, Fn fn);
+
+    private:
+
+        struct Group {
+            Group(int n, const std::function<void(int)>& f) :pending(n), fn(f) {}
+
+            std::atomic<int> pending;
+            const std::function<void(int)>& fn;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+
+        struct Task {
+            Group* group;
+            int index;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        void work(int id);
+        bool pop(int id, Task& task);
+        bool steal(int id, Task& task);
+        void execute(const Task& task);
+
+        std::vector<std::thread> m_workers;
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        std::atomic<int> m_queued;
+        std::atomic<unsigned> m_next;
+        bool m_stop;
+    };
+
+    template <class Fn>
+    void ThreadPool::parallelFor(index_t begin, index_t end, index_t grain, Fn fn) {
+        index_t n = end - begin;
+        if (n <= 0)
+            return;
+        if (grain < 1)
+            grain = 1;
+        int nchunks = static_cast<int>(std::min<index_t>((n + grain - 1) / grain, 4 * concurrency()));
+        if (nchunks <= 1) {
+            fn(begin, end);
+            return;
+        }
+        index_t q = n / nchunks, r = n % nchunks;
+        run(nchunks, [=, &fn](int k) {
+            index_t i0 = begin + k * q + std::min<index_t>(k, r);
+            index_t i1 = i0 + q + (k < r ? 1 : 0);
+            fn(i0, i1);
+            });
+    }
+}
+
+#endif
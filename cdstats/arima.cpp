@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cmath>
 #include "arima.h"
 #include "polynomials.h"
+#include "schurcohn.h"
+#include "smallblock.h"
 
 using namespace NUMCPP;
 using namespace CD_STATS;
@@ -15,6 +19,7 @@ Arima& Arima::operator=(const Arima& arima) {
 		m_ar = arima.m_ar;
 		m_star = arima.m_star;
 		m_delta = arima.m_delta;
+		m_ma = arima.m_ma;
 		m_var = arima.m_var;
 	}
 	return *this;
@@ -24,5 +29,57 @@ Arima::Arima(const Polynomial& ar, const Polynomial& delta, const Polynomial& ma
 	:m_star(ar), m_ar(ar*delta), m_delta(delta), m_ma(ma), m_var(var) {
 }
 
+bool Arima::hasStationaryAr() {
+	return SchurCohn::isStable(m_star);
+}
+
+bool Arima::isInvertible() {
+	return SchurCohn::isStable(m_ma);
+}
+
+namespace {
 
+	// p = q g + r with |r| <= tolerance |p| (max norms of the coefficients): q in p.
+	// q is scaled so that p keeps its constant term. Returns false (p unchanged) if g
+	// doesn't divide p within tolerance
+	bool reduce(Polynomial& p, const Polynomial& g, double tolerance, Polynomial& q, Polynomial& r) {
+		Polynomial::divide(p, g, q, r);
+		double pmax = 0, rmax = 0;
+		for (int i = 0; i <= p.getDegree(); ++i)
+			pmax = std::max(pmax, std::abs(p[i]));
+		for (int i = 0; i <= r.getDegree(); ++i)
+			rmax = std::max(rmax, std::abs(r[i]));
+		if (!q.isValid() || !(rmax <= tolerance * pmax))
+			return false;
+		if (q[0] != 0)
+			q *= p[0] / q[0];
+		return true;
+	}
+}
 
+int Arima::simplify(double tolerance) {
+	Polynomial g = Polynomial::approximateGcd(m_star, m_ma, tolerance);
+	int dg = g.getDegree();
+	// a common root at 0 is not cancelled: the reduced polynomials keep their constant terms
+	int z = 0;
+	while (z < dg && g[z] == 0)
+		++z;
+	if (z > 0) {
+		SmallBlock<double> c(dg - z + 1);
+		for (int i = z; i <= dg; ++i)
+			c(i - z) = g[i];
+		dg -= z;
+		g = Polynomial(dg, c.data());
+	}
+	if (dg <= 0)
+		return 0;
+	// the roots of g are means of the roots of both polynomials: g only divides them
+	// approximately, and the remainders are checked before the cancellation
+	Polynomial star, ma, r;
+	if (!reduce(m_star, g, tolerance, star, r) || !reduce(m_ma, g, tolerance, ma, r))
+		return 0;
+	m_star = std::move(star);
+	m_ma = std::move(ma);
+	m_ar = m_star * m_delta;
+	return dg;
+}
@@ -54,6 +54,27 @@ namespace CD_STATS {
 		double getInnovationVariance();
 		bool isStationary();
 
+		/// <summary>
+		/// True if all the roots of the stationary AR polynomial are outside the unit circle
+		/// </summary>
+		bool hasStationaryAr();
+
+		/// <summary>
+		/// True if all the roots of the MA polynomial are outside the unit circle
+		/// </summary>
+		bool isInvertible();
+
+		/// <summary>
+		/// Cancels the common factors of the stationary AR and MA polynomials
+		/// (roots that match within tolerance, see Polynomial::approximateGcd).
+		/// The polynomials are divided by the common factor; nothing is cancelled when
+		/// a remainder is above tolerance times the largest coefficient. The reduced
+		/// polynomials are scaled to keep their constant terms, and a common root at 0
+		/// is not cancelled. The non-stationary part is not modified.
+		/// Returns the number of cancelled roots
+		/// </summary>
+		int simplify(double tolerance = 1e-4);
+
 	private:
 
 		NUMCPP::Polynomial m_star, m_ar, m_delta, m_ma;